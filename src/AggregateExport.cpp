@@ -0,0 +1,239 @@
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <stdexcept>
+#include <map>
+#include <algorithm>
+
+
+#include "AggregateExport.h"
+#include "Helpers.h"
+#include "PlayDictionary.h"
+
+
+using namespace std;
+
+
+namespace {
+    //outcomes and best play of one play code within a shard
+    struct CellAggregate {
+        long plays = 0;
+        long firstDowns = 0;
+        long touchdowns = 0;
+        long fieldGoals = 0;
+        long twoPoints = 0;
+        int bestRow = -1;
+        int bestRating = 0;
+    };
+
+    template <typename Value>
+    void writeColumn(ostream& out, const string& name, const vector<int>& rows, const vector<Play>& plays, Value value) {
+        out << "\"" << name << "\":[";
+        for (int i = 0; i < static_cast<int>(rows.size()); i++) {
+            out << (i == 0 ? "" : ",") << value(plays[rows[i]]);
+        }
+        out << "]";
+    }
+
+    string shardName(int quarter, int down) {
+        return "q" + to_string(quarter) + "d" + to_string(down);
+    }
+}
+
+
+void ExportSummary::print(const string& outputDirectory) const {
+    cout << "Exported " << plays << " plays to " << outputDirectory << "\n";
+    cout << "    manifest: " << manifestBytes << " bytes\n";
+    cout << "    " << situationShards << " situation shards: " << situationBytes << " bytes\n";
+    cout << "    " << textShards << " description shards: " << textBytes << " bytes\n";
+}
+
+
+int AggregateExport::flagsOf(const Play& play) {
+    int flags = 0;
+    if (play.resultIsFirstDown) flags |= FIRST_DOWN_FLAG;
+    if (play.isTouchdown) flags |= TOUCHDOWN_FLAG;
+    if (play.isRush) flags |= RUSH_FLAG;
+    if (play.isPass) flags |= PASS_FLAG;
+    if (play.isIncomplete) flags |= INCOMPLETE_FLAG;
+    if (play.isSack) flags |= SACK_FLAG;
+    if (play.isInterception) flags |= INTERCEPTION_FLAG;
+    if (play.isFumble) flags |= FUMBLE_FLAG;
+    if (play.isTwoPointConversion) flags |= TWO_POINT_FLAG;
+    if (play.isTwoPointConversionSuccessful) flags |= TWO_POINT_SUCCESS_FLAG;
+    if (play.outcomes & FIELD_GOAL_OUTCOME) flags |= FIELD_GOAL_GOOD_FLAG;
+    //the dashboard splits two point conversions into passes and rushes by this, it is parsed from the description at ingest
+    if (play.twoPointMethod == TWO_POINT_PASS) flags |= DESCRIPTION_PASS_FLAG;
+    return flags;
+}
+
+
+void AggregateExport::writeString(ostream& out, const string& value) {
+    out << '"';
+    for (char c : value) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20) {
+            //control characters never show up in descriptions, so they are dropped instead of escaped
+            out << ' ';
+        }
+        else {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+
+long AggregateExport::writeFile(const string& filename, const string& contents) {
+    ofstream file(filename, ios::binary);
+    if (!file.is_open()) {
+        throw runtime_error("Could not write " + filename);
+    }
+    file << contents;
+    return static_cast<long>(contents.size());
+}
+
+
+ExportSummary AggregateExport::write(const vector<Play>& plays, const string& outputDirectory) {
+    filesystem::create_directories(outputDirectory + "/situations");
+    filesystem::create_directories(outputDirectory + "/text");
+
+    //rows[quarter * DOWNS + down] are the indices of the plays of that shard in file order
+    vector<vector<int>> rows(QUARTERS * DOWNS);
+    for (int i = 0; i < static_cast<int>(plays.size()); i++) {
+        const Play& play = plays[i];
+        if (play.quarter < 1 || play.quarter > QUARTERS || play.down < 0 || play.down >= DOWNS) {
+            continue;
+        }
+        rows[(play.quarter - 1) * DOWNS + play.down].push_back(i);
+    }
+
+    ExportSummary summary;
+    ostringstream shardList;
+    for (int quarter = 1; quarter <= QUARTERS; quarter++) {
+        for (int down = 0; down < DOWNS; down++) {
+            const vector<int>& shardRows = rows[(quarter - 1) * DOWNS + down];
+            if (shardRows.empty()) {
+                continue;
+            }
+            string name = shardName(quarter, down);
+
+            //aggregates of every play code, ordered by code so the output is the same on every run
+            map<string, CellAggregate> cells;
+            CellAggregate total;
+            for (int row = 0; row < static_cast<int>(shardRows.size()); row++) {
+                const Play& play = plays[shardRows[row]];
+                CellAggregate& cell = cells[Helpers::generatePlayCode(play)];
+                for (CellAggregate* aggregate : {&cell, &total}) {
+                    aggregate->plays++;
+                    aggregate->firstDowns += (play.outcomes & FIRST_DOWN_OUTCOME) ? 1 : 0;
+                    aggregate->touchdowns += (play.outcomes & TOUCHDOWN_OUTCOME) ? 1 : 0;
+                    aggregate->fieldGoals += (play.outcomes & FIELD_GOAL_OUTCOME) ? 1 : 0;
+                    aggregate->twoPoints += (play.outcomes & TWO_POINT_OUTCOME) ? 1 : 0;
+                    if (aggregate->bestRow == -1 || play.rating > aggregate->bestRating) {
+                        aggregate->bestRow = row;
+                        aggregate->bestRating = play.rating;
+                    }
+                }
+            }
+
+            ostringstream shard;
+            shard << "{\"quarter\":" << quarter << ",\"down\":" << down << ",\"plays\":" << shardRows.size() << ",\"columns\":{";
+            writeColumn(shard, "gameID", shardRows, plays, [](const Play& play) { return play.gameID; });
+            shard << ",";
+            writeColumn(shard, "date", shardRows, plays, [](const Play& play) { return play.dateAsInt; });
+            shard << ",";
+            writeColumn(shard, "minutes", shardRows, plays, [](const Play& play) { return play.minutes; });
+            shard << ",";
+            writeColumn(shard, "seconds", shardRows, plays, [](const Play& play) { return play.seconds; });
+            shard << ",";
+            writeColumn(shard, "offense", shardRows, plays, [](const Play& play) { return play.offenseCode; });
+            shard << ",";
+            writeColumn(shard, "defense", shardRows, plays, [](const Play& play) { return play.defenseCode; });
+            shard << ",";
+            writeColumn(shard, "toGo", shardRows, plays, [](const Play& play) { return play.toGo; });
+            shard << ",";
+            writeColumn(shard, "yardLine", shardRows, plays, [](const Play& play) { return play.yardLine; });
+            shard << ",";
+            writeColumn(shard, "yards", shardRows, plays, [](const Play& play) { return play.resultingYards; });
+            shard << ",";
+            writeColumn(shard, "formation", shardRows, plays, [](const Play& play) { return play.formationCode; });
+            shard << ",";
+            writeColumn(shard, "playType", shardRows, plays, [](const Play& play) { return play.playTypeCode; });
+            shard << ",";
+            writeColumn(shard, "passType", shardRows, plays, [](const Play& play) { return play.passTypeCode; });
+            shard << ",";
+            writeColumn(shard, "rushDirection", shardRows, plays, [](const Play& play) { return play.rushDirectionCode; });
+            shard << ",";
+            writeColumn(shard, "flags", shardRows, plays, [](const Play& play) { return flagsOf(play); });
+            //[plays, first downs, touchdowns, field goals, two point conversions, row of the best rated play]
+            shard << "},\"cells\":{";
+            bool firstCell = true;
+            for (const pair<const string, CellAggregate>& cell : cells) {
+                const CellAggregate& aggregate = cell.second;
+                shard << (firstCell ? "" : ",") << "\"" << cell.first << "\":[" << aggregate.plays << "," << aggregate.firstDowns
+                      << "," << aggregate.touchdowns << "," << aggregate.fieldGoals << "," << aggregate.twoPoints << ","
+                      << aggregate.bestRow << "]";
+                firstCell = false;
+            }
+            shard << "}}";
+            summary.situationBytes += writeFile(outputDirectory + "/situations/" + name + ".json", shard.str());
+            summary.situationShards++;
+
+            //descriptions are most of the size, so they are split by yardLine and only fetched for the best play
+            for (int tens = 0; tens < YARD_LINE_TENS; tens++) {
+                ostringstream text;
+                text << "{\"rows\":[";
+                ostringstream descriptions;
+                int written = 0;
+                for (int row = 0; row < static_cast<int>(shardRows.size()); row++) {
+                    const Play& play = plays[shardRows[row]];
+                    if (min(max(play.yardLine / 10, 0), YARD_LINE_TENS - 1) != tens) {
+                        continue;
+                    }
+                    text << (written == 0 ? "" : ",") << row;
+                    descriptions << (written == 0 ? "" : ",");
+                    writeString(descriptions, play.description);
+                    written++;
+                }
+                if (written == 0) {
+                    continue;
+                }
+                text << "],\"descriptions\":[" << descriptions.str() << "]}";
+                summary.textBytes += writeFile(outputDirectory + "/text/" + name + "y" + to_string(tens) + ".json", text.str());
+                summary.textShards++;
+            }
+
+            shardList << (summary.situationShards == 1 ? "" : ",") << "\"" << name << "\":[" << total.plays << ","
+                      << total.firstDowns << "," << total.touchdowns << "," << total.fieldGoals << "," << total.twoPoints << "]";
+            summary.plays += total.plays;
+        }
+    }
+
+    //dictionary codes index these arrays, passType, rushDirection and formation share the sub type dictionary
+    ostringstream manifest;
+    manifest << "{\"version\":1,\"plays\":" << summary.plays;
+    const pair<string, PlayDictionary::Field> DICTIONARIES[] = {
+        {"teams", PlayDictionary::TEAM}, {"playTypes", PlayDictionary::PLAY_TYPE}, {"subTypes", PlayDictionary::SUB_TYPE}
+    };
+    for (const pair<string, PlayDictionary::Field>& dictionary : DICTIONARIES) {
+        manifest << ",\"" << dictionary.first << "\":[";
+        for (int code = 0; code < PlayDictionary::size(dictionary.second); code++) {
+            manifest << (code == 0 ? "" : ",");
+            writeString(manifest, PlayDictionary::decode(dictionary.second, code));
+        }
+        manifest << "]";
+    }
+    manifest << ",\"flags\":{\"firstDown\":" << FIRST_DOWN_FLAG << ",\"touchdown\":" << TOUCHDOWN_FLAG << ",\"rush\":" << RUSH_FLAG
+             << ",\"pass\":" << PASS_FLAG << ",\"incomplete\":" << INCOMPLETE_FLAG << ",\"sack\":" << SACK_FLAG
+             << ",\"interception\":" << INTERCEPTION_FLAG << ",\"fumble\":" << FUMBLE_FLAG << ",\"twoPoint\":" << TWO_POINT_FLAG
+             << ",\"twoPointSuccess\":" << TWO_POINT_SUCCESS_FLAG << ",\"fieldGoalGood\":" << FIELD_GOAL_GOOD_FLAG
+             << ",\"descriptionPass\":" << DESCRIPTION_PASS_FLAG << "}";
+    //[plays, first downs, touchdowns, field goals, two point conversions] of every shard
+    manifest << ",\"shards\":{" << shardList.str() << "}}";
+    summary.manifestBytes = writeFile(outputDirectory + "/manifest.json", manifest.str());
+
+    return summary;
+}
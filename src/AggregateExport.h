@@ -0,0 +1,55 @@
+#pragma once
+#include <iostream>
+#include <string>
+#include <vector>
+
+
+#include "Play.h"
+
+
+using namespace std;
+
+
+//what an export wrote, printed by the export tool
+struct ExportSummary {
+    long plays = 0;
+    int situationShards = 0;
+    int textShards = 0;
+    long situationBytes = 0;
+    long textBytes = 0;
+    long manifestBytes = 0;
+
+    void print(const string& outputDirectory) const;
+};
+
+
+//writes the plays as sharded JSON so the web dashboard only downloads the situations a query needs
+//   manifest.json                  dictionaries, the flag bits, and the plays and outcomes of every shard
+//   situations/q<Q>d<D>.json       every play of a quarter and down as columns, plus aggregates and the best play
+//                                  of every play code (see Helpers::generatePlayCode) within it
+//   text/q<Q>d<D>y<T>.json         descriptions of the plays of a shard whose yardLine is within T0-T9,
+//                                  only fetched to show the best play
+class AggregateExport {
+public:
+    //bits of the flags column
+    enum ExportFlag {
+        FIRST_DOWN_FLAG = 1, TOUCHDOWN_FLAG = 2, RUSH_FLAG = 4, PASS_FLAG = 8, INCOMPLETE_FLAG = 16, SACK_FLAG = 32,
+        INTERCEPTION_FLAG = 64, FUMBLE_FLAG = 128, TWO_POINT_FLAG = 256, TWO_POINT_SUCCESS_FLAG = 512,
+        FIELD_GOAL_GOOD_FLAG = 1024, DESCRIPTION_PASS_FLAG = 2048
+    };
+
+    //quarters 1-5 (overtime is 5) and downs 0-4, like the bounds of the console prompts
+    static constexpr int QUARTERS = 5;
+    static constexpr int DOWNS = 5;
+    static constexpr int YARD_LINE_TENS = 10;
+
+    //creates the directories under outputDirectory and writes every shard, throws runtime_error if a file can't be written
+    static ExportSummary write(const vector<Play>& plays, const string& outputDirectory);
+
+private:
+    static int flagsOf(const Play& play);
+
+    static void writeString(ostream& out, const string& value);
+
+    static long writeFile(const string& filename, const string& contents);
+};
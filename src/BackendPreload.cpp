@@ -0,0 +1,118 @@
+#include <iostream>
+#include <chrono>
+
+
+#include "BackendPreload.h"
+
+
+using namespace std;
+
+
+BackendPreload::~BackendPreload() {
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+
+void BackendPreload::start(const string& dataPath, const IngestConfig& ingestConfig, const Builder& heapBuilder,
+                           const Builder& hashTableBuilder) {
+    path = dataPath;
+    config = ingestConfig;
+    builders[HEAP_BACKEND] = heapBuilder;
+    builders[HASH_TABLE_BACKEND] = hashTableBuilder;
+    for (int backend = 0; backend < BACKEND_COUNT; backend++) {
+        stages[backend] = builders[backend] ? PARSING : NOT_PRELOADED;
+    }
+    worker = thread(&BackendPreload::run, this);
+}
+
+
+bool BackendPreload::enabled(Backend backend) const {
+    lock_guard<mutex> lock(preloadMutex);
+    return stages[backend] != NOT_PRELOADED;
+}
+
+
+bool BackendPreload::ready(Backend backend) const {
+    lock_guard<mutex> lock(preloadMutex);
+    return stages[backend] == READY;
+}
+
+
+void BackendPreload::wait(Backend backend) {
+    unique_lock<mutex> lock(preloadMutex);
+    stageChanged.wait(lock, [&] { return stages[backend] == READY || stages[backend] == NOT_PRELOADED; });
+}
+
+
+string BackendPreload::status() const {
+    const string NAMES[BACKEND_COUNT] = {"heap", "hash table"};
+    const string STAGES[] = {"", "reading data", "queued", "building", "ready"};
+
+    lock_guard<mutex> lock(preloadMutex);
+    string status;
+    for (int backend = 0; backend < BACKEND_COUNT; backend++) {
+        if (stages[backend] == NOT_PRELOADED) {
+            continue;
+        }
+        status += (status.empty() ? " (" : ", ") + NAMES[backend] + ": " + STAGES[stages[backend]];
+    }
+    return status.empty() ? status : status + ")";
+}
+
+
+void BackendPreload::printBuild(Backend backend) const {
+    lock_guard<mutex> lock(preloadMutex);
+    cout << "Read the data once in " << parseSeconds << " seconds, then built in the background in "
+         << buildSeconds[backend] << " seconds!\n";
+    stats.print(config);
+    cout << logs[backend].str();
+}
+
+
+void BackendPreload::run() {
+    auto start = chrono::steady_clock::now();
+    vector<Play> plays;
+    IngestStats parsed = PlayIngest::readFiles(PlayIngest::listDataFiles(path), config, plays);
+
+    vector<Play> hashTablePlays;
+    if (builders[HASH_TABLE_BACKEND]) {
+        hashTablePlays = PlayIngest::takeHashTablePlays(plays, static_cast<bool>(builders[HEAP_BACKEND]));
+    }
+    vector<Play>* backendPlays[BACKEND_COUNT] = {&plays, &hashTablePlays};
+
+    {
+        lock_guard<mutex> lock(preloadMutex);
+        stats = parsed;
+        parseSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        for (int backend = 0; backend < BACKEND_COUNT; backend++) {
+            if (stages[backend] == PARSING) {
+                stages[backend] = QUEUED;
+            }
+        }
+    }
+    stageChanged.notify_all();
+
+    for (int backend = 0; backend < BACKEND_COUNT; backend++) {
+        if (!builders[backend]) {
+            continue;
+        }
+        {
+            lock_guard<mutex> lock(preloadMutex);
+            stages[backend] = BUILDING;
+        }
+
+        //logs are only read after the stage is READY, so they are written without the lock
+        auto buildStart = chrono::steady_clock::now();
+        builders[backend](*backendPlays[backend], logs[backend]);
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - buildStart).count();
+
+        {
+            lock_guard<mutex> lock(preloadMutex);
+            buildSeconds[backend] = seconds;
+            stages[backend] = READY;
+        }
+        stageChanged.notify_all();
+    }
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <sstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+
+#include "Play.h"
+#include "PlayIngest.h"
+
+
+using namespace std;
+
+
+enum Backend {HEAP_BACKEND, HASH_TABLE_BACKEND, BACKEND_COUNT};
+
+
+//parses the data once on a background thread and builds every enabled data structure from that parse
+//the prompts keep running meanwhile, a query only waits for the data structure it uses
+class BackendPreload {
+public:
+    //builds a data structure from the parsed plays, anything it reports goes to log instead of cout
+    using Builder = function<void(vector<Play>& plays, ostream& log)>;
+
+    ~BackendPreload();
+
+    //an empty builder means that data structure isn't preloaded
+    void start(const string& path, const IngestConfig& config, const Builder& heapBuilder, const Builder& hashTableBuilder);
+
+    bool enabled(Backend backend) const;
+
+    bool ready(Backend backend) const;
+
+    //blocks until the data structure is built
+    void wait(Backend backend);
+
+    //like " (heap: ready, hash table: building)", empty if nothing is preloaded
+    string status() const;
+
+    //what the parse and the build reported, printed once the data structure is first used
+    void printBuild(Backend backend) const;
+
+private:
+    enum Stage {NOT_PRELOADED, PARSING, QUEUED, BUILDING, READY};
+
+    void run();
+
+    thread worker;
+    mutable mutex preloadMutex;
+    condition_variable stageChanged;
+
+    string path;
+    IngestConfig config;
+    Builder builders[BACKEND_COUNT];
+
+    Stage stages[BACKEND_COUNT] = {NOT_PRELOADED, NOT_PRELOADED};
+    IngestStats stats;
+    double parseSeconds = 0;
+    double buildSeconds[BACKEND_COUNT] = {};
+    ostringstream logs[BACKEND_COUNT];
+};
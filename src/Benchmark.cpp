@@ -0,0 +1,235 @@
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <random>
+#include <algorithm>
+
+
+#include "Benchmark.h"
+#include "PlayMaxHeap.h"
+#include "PackedSituations.h"
+#include "MemoryAccounting.h"
+#include "DatasetSnapshot.h"
+
+
+using namespace std;
+
+
+namespace {
+    //the same totals as PackedSituations::aggregate, added up from the plays themselves
+    PackedTotals aggregatePlays(const vector<Play>& plays, const SituationBounds& bounds) {
+        PackedTotals totals;
+        for (const Play& play : plays) {
+            if (bounds.matches(play)) {
+                totals.situations++;
+                totals.firstDowns += (play.outcomes & FIRST_DOWN_OUTCOME) ? 1 : 0;
+                totals.touchdowns += (play.outcomes & TOUCHDOWN_OUTCOME) ? 1 : 0;
+                totals.fieldGoals += (play.outcomes & FIELD_GOAL_OUTCOME) ? 1 : 0;
+                totals.twoPoints += (play.outcomes & TWO_POINT_OUTCOME) ? 1 : 0;
+            }
+        }
+        return totals;
+    }
+
+    //the latency at the given fraction of the sorted latencies
+    double percentile(const vector<double>& sorted, double fraction) {
+        if (sorted.empty()) {
+            return 0;
+        }
+        return sorted[min(sorted.size() - 1, static_cast<size_t>(fraction * sorted.size()))];
+    }
+
+    void printLatencies(const string& title, vector<double>& latencies) {
+        sort(latencies.begin(), latencies.end());
+        cout << title << latencies.size() << " queries, p50 " << percentile(latencies, 0.5) << " us, p99 "
+             << percentile(latencies, 0.99) << " us, max " << (latencies.empty() ? 0 : latencies.back()) << " us\n";
+    }
+
+    bool sameTotals(const PackedTotals& a, const PackedTotals& b) {
+        return a.situations == b.situations && a.firstDowns == b.firstDowns && a.touchdowns == b.touchdowns
+               && a.fieldGoals == b.fieldGoals && a.twoPoints == b.twoPoints;
+    }
+}
+
+
+int Benchmark::run(const string& path, const IngestConfig& config, int queries) {
+    PlayMaxHeap maxHeap;
+    IngestStats stats = PlayMaxHeap::readDataAndPushIntoHeap(path, maxHeap, config);
+    stats.print(config);
+    if (maxHeap.empty()) {
+        cout << "No plays to benchmark.\n";
+        return 1;
+    }
+
+    //queries are the situations of plays spread evenly through the heap, so most of them have matches
+    vector<SituationBounds> bounds;
+    int step = max(1, maxHeap.size() / queries);
+    for (int i = 0; i < queries; i++) {
+        bounds.push_back(Helpers::calculateSituationBounds(maxHeap.at((i * step) % maxHeap.size())));
+    }
+
+    //the peak is reset before every query, so it only covers what that query allocated
+    bool measuresPeak = MemoryAccounting::resetPeak();
+    long largestPeakGrowth = 0;
+    long totalPeakGrowth = 0;
+
+    long matched = 0;
+    int mismatches = 0;
+    chrono::nanoseconds unpackedTime(0);
+    chrono::nanoseconds packedTime(0);
+    chrono::nanoseconds clusteredTime(0);
+    long clusteredBytes = 0;
+    long clusteredRows = 0;
+    for (const SituationBounds& query : bounds) {
+        long resident = MemoryAccounting::residentBytes();
+        if (measuresPeak) {
+            MemoryAccounting::resetPeak();
+        }
+
+        auto start = chrono::high_resolution_clock::now();
+        PackedTotals unpacked = aggregatePlays(maxHeap.getPlays(), query);
+        auto middle = chrono::high_resolution_clock::now();
+        PackedTotals packed = maxHeap.getPacked().aggregate(query);
+        auto stop = chrono::high_resolution_clock::now();
+        PackedTotals clustered = maxHeap.getClustered().aggregate(query);
+        auto clusteredStop = chrono::high_resolution_clock::now();
+        //the rows a query hands to the tally, like the heap scan does
+        vector<int> rows = maxHeap.getPacked().matchingRows(query);
+
+        if (measuresPeak) {
+            long growth = max(0L, MemoryAccounting::peakResidentBytes() - resident);
+            largestPeakGrowth = max(largestPeakGrowth, growth);
+            totalPeakGrowth += growth;
+        }
+
+        unpackedTime += chrono::duration_cast<chrono::nanoseconds>(middle - start);
+        packedTime += chrono::duration_cast<chrono::nanoseconds>(stop - middle);
+        clusteredTime += chrono::duration_cast<chrono::nanoseconds>(clusteredStop - stop);
+        matched += packed.situations;
+        //the bytes the clustered layout reads for the query, counted outside of the timing
+        uint64_t lower;
+        uint64_t upper;
+        if (PackedSituations::packBounds(query, lower, upper)) {
+            vector<SituationRun> runs = maxHeap.getClustered().runs(lower, upper, clusteredBytes);
+            ClusteredScan scan = maxHeap.getClustered().scan(runs, lower, upper);
+            clusteredBytes += scan.bytesTouched;
+            clusteredRows += scan.scannedRows;
+        }
+
+        if (!sameTotals(unpacked, packed) || !sameTotals(packed, clustered) || static_cast<long>(rows.size()) != packed.situations) {
+            mismatches++;
+        }
+    }
+
+    double scannedPlays = static_cast<double>(maxHeap.size()) * queries;
+    cout << "Scanned " << maxHeap.size() << " plays " << queries << " times, " << matched << " similar situations in total\n";
+    cout << "Unpacked plays: " << sizeof(Play) << " bytes per play, "
+         << static_cast<double>(unpackedTime.count()) / scannedPlays << " ns per play\n";
+    cout << "Packed words:   " << maxHeap.getPacked().bytesPerPlay() << " bytes per play, "
+         << static_cast<double>(packedTime.count()) / scannedPlays << " ns per play\n";
+    cout << "Clustered runs: " << static_cast<double>(clusteredTime.count()) / queries << " ns per query, "
+         << clusteredRows / queries << " rows and " << clusteredBytes / queries << " bytes touched per query instead of "
+         << maxHeap.size() * maxHeap.getPacked().bytesPerPlay() << "\n";
+    maxHeap.memoryUsage().print();
+    if (measuresPeak) {
+        cout << "Peak resident set growth per query: " << MemoryAccounting::formatBytes(totalPeakGrowth / queries)
+             << " on average, " << MemoryAccounting::formatBytes(largestPeakGrowth) << " at most, on top of "
+             << MemoryAccounting::formatBytes(MemoryAccounting::residentBytes()) << endl;
+    }
+    else {
+        cout << "Peak resident set per query can't be measured here\n";
+    }
+    if (mismatches > 0) {
+        cout << mismatches << " queries counted differently with the packed words or clustered runs!\n";
+        return 1;
+    }
+    return 0;
+}
+
+
+int Benchmark::stress(const string& path, const IngestConfig& config, int seconds) {
+    DatasetOptions options;
+    DatasetStore store;
+    store.publish(Dataset::load(path, config, options, 0, true, false));
+    if (store.current()->maxHeap.empty()) {
+        cout << "No plays to stress.\n";
+        return 1;
+    }
+    cout << store.current()->report;
+
+    //the same queries as --bench, every reload reads the same data so each of them has to count the same totals every time
+    const PlayMaxHeap& firstHeap = store.current()->maxHeap;
+    vector<SituationBounds> bounds;
+    vector<PackedTotals> expected;
+    int queryCount = min(1000, firstHeap.size());
+    int step = max(1, firstHeap.size() / queryCount);
+    for (int i = 0; i < queryCount; i++) {
+        bounds.push_back(Helpers::calculateSituationBounds(firstHeap.at((i * step) % firstHeap.size())));
+        expected.push_back(firstHeap.getPacked().aggregate(bounds.back()));
+    }
+
+    atomic<bool> stop{false};
+    atomic<bool> reloadRunning{false};
+    atomic<int> mismatches{0};
+    int readerCount = max(2, static_cast<int>(thread::hardware_concurrency()) - 1);
+    //latencies in microseconds, kept apart by whether a reload was running when the query started
+    vector<vector<double>> steady(readerCount);
+    vector<vector<double>> duringReload(readerCount);
+
+    vector<thread> readers;
+    for (int r = 0; r < readerCount; r++) {
+        readers.emplace_back([&, r]() {
+            mt19937 random(r);
+            while (!stop) {
+                bool reloading = reloadRunning;
+                auto start = chrono::high_resolution_clock::now();
+                int query = random() % queryCount;
+                shared_ptr<Dataset> dataset = store.current();
+                PackedTotals totals = dataset->maxHeap.getPacked().aggregate(bounds[query]);
+                auto finish = chrono::high_resolution_clock::now();
+                if (!sameTotals(totals, expected[query])) {
+                    mismatches++;
+                }
+                double latency = chrono::duration<double, micro>(finish - start).count();
+                (reloading ? duringReload[r] : steady[r]).push_back(latency);
+            }
+        });
+    }
+
+    //reloads back to back until the time is up, each one swapped in while the readers keep going
+    int reloads = 0;
+    auto deadline = chrono::steady_clock::now() + chrono::seconds(seconds);
+    while (chrono::steady_clock::now() < deadline) {
+        reloadRunning = true;
+        shared_ptr<Dataset> next = Dataset::load(path, config, options, reloads + 1, true, false);
+        store.publish(next);
+        reloadRunning = false;
+        reloads++;
+        //a moment without a reload, so there are steady queries to compare against
+        this_thread::sleep_for(chrono::milliseconds(200));
+    }
+    stop = true;
+    for (thread& reader : readers) {
+        reader.join();
+    }
+
+    vector<double> steadyLatencies;
+    vector<double> reloadLatencies;
+    for (int r = 0; r < readerCount; r++) {
+        steadyLatencies.insert(steadyLatencies.end(), steady[r].begin(), steady[r].end());
+        reloadLatencies.insert(reloadLatencies.end(), duringReload[r].begin(), duringReload[r].end());
+    }
+    cout << reloads << " reloads swapped in under " << readerCount << " query threads\n";
+    printLatencies("Without a reload: ", steadyLatencies);
+    printLatencies("During a reload:  ", reloadLatencies);
+
+    //only the dataset still published should be alive once every query has finished
+    long live = Dataset::liveCount();
+    cout << "Datasets still alive: " << live << endl;
+    if (mismatches > 0) {
+        cout << mismatches << " queries counted different totals than the first dataset!\n";
+        return 1;
+    }
+    return live == 1 ? 0 : 1;
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include <string>
+
+
+#include "PlayIngest.h"
+
+
+using namespace std;
+
+
+//times the situation scans over the same queries instead of prompting, run with --bench
+class Benchmark {
+public:
+    //builds the heap from the data, then scans it once per query with the unpacked plays, the packed words and the clustered runs
+    //returns the exit code, 1 if the scans ever disagree
+    static int run(const string& path, const IngestConfig& config, int queries);
+
+    //runs packed situation queries on several threads while the data is reloaded and swapped in over and over, run with --stress
+    //reports the query latency while a reload is running next to the latency without one
+    //returns the exit code, 1 if a query ever counts different totals than on the first dataset or an old dataset is never freed
+    static int stress(const string& path, const IngestConfig& config, int seconds);
+};
@@ -0,0 +1,29 @@
+#include "BucketSummary.h"
+#include "Helpers.h"
+
+
+using namespace std;
+
+
+//checks if every play of the summary is within the bounds
+//summaries aren't split by team, so a team filter always needs the plays to be filtered
+bool BucketSummary::isCoveredBy(const SituationBounds& bounds) const {
+    return !bounds.hasTeamFilter()
+           && minQuarter == bounds.quarter && maxQuarter == bounds.quarter
+           && minDown == bounds.down && maxDown == bounds.down
+           && minToGo >= bounds.toGoLowerBound && maxToGo <= bounds.toGoUpperBound
+           && minYardLine >= bounds.yardLineLowerBound && maxYardLine <= bounds.yardLineUpperBound
+           && minTime >= bounds.timeLowerBound && maxTime <= bounds.timeUpperBound
+           && minSeason >= bounds.firstSeason && maxSeason <= bounds.lastSeason;
+}
+
+
+bool BucketSummary::overlapsSeasons(const SituationBounds& bounds) const {
+    return maxSeason >= bounds.firstSeason && minSeason <= bounds.lastSeason;
+}
+
+
+long BucketSummary::memoryBytes() const {
+    return static_cast<long>(sizeof(BucketSummary) + playCode.capacity() + (byRating.capacity() + byPosition.capacity()) * sizeof(Play*))
+           + tally.memoryBytes() + twoPointTally.memoryBytes();
+}
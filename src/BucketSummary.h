@@ -0,0 +1,53 @@
+#pragma once
+#include <string>
+#include <vector>
+
+
+#include "Play.h"
+#include "SuccessTally.h"
+
+
+using namespace std;
+
+
+struct SituationBounds;
+
+
+//outcomes of every play in a hash bucket that shares a play code, computed once at ingest
+//a bucket can hold more than one play code because different codes can hash to the same index
+//the play code and bounds come first, so a query checking a summary reads at most two cache lines of it
+struct BucketSummary {
+    string playCode;
+
+    //smallest and largest situation values of the plays, so a query can tell if it covers all of them
+    int minQuarter;
+    int maxQuarter;
+    int minDown;
+    int maxDown;
+    int minToGo;
+    int maxToGo;
+    int minYardLine;
+    int maxYardLine;
+    int minTime;
+    int maxTime;
+    int minSeason;
+    int maxSeason;
+
+    //counts for when the query is or isn't a two point conversion
+    SuccessTally tally;
+    SuccessTally twoPointTally;
+
+    //plays from highest to lowest rating, equal ratings in the order they were read
+    vector<Play*> byRating;
+    //plays ordered by yardLine then time so a partially covered summary only filters a slice
+    vector<Play*> byPosition;
+
+    //checks if every play of the summary is within the bounds
+    bool isCoveredBy(const SituationBounds& bounds) const;
+
+    //checks if any play of the summary is within the season range of the bounds
+    bool overlapsSeasons(const SituationBounds& bounds) const;
+
+    //bytes held by the tallies and play lists, not the plays themselves
+    long memoryBytes() const;
+};
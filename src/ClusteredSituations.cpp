@@ -0,0 +1,140 @@
+#include <algorithm>
+#include <numeric>
+
+
+#include "ClusteredSituations.h"
+
+
+using namespace std;
+
+
+//sorts heap indices by the situation key of their words, stable so equal situations stay in heap order
+void ClusteredSituations::build(const PackedSituations& packed) {
+    const vector<uint64_t>& heapWords = packed.getWords();
+    int count = static_cast<int>(heapWords.size());
+
+    vector<uint32_t> keys(count);
+    for (int i = 0; i < count; i++) {
+        keys[i] = PackedSituations::situationKey(heapWords[i]);
+    }
+    rows.resize(count);
+    iota(rows.begin(), rows.end(), 0);
+    stable_sort(rows.begin(), rows.end(), [&keys](int a, int b) {
+        return keys[a] < keys[b];
+    });
+
+    words.resize(count);
+    fences.clear();
+    for (int i = 0; i < count; i++) {
+        words[i] = heapWords[rows[i]];
+        if (i % FENCE_SPACING == 0) {
+            fences.push_back(keys[rows[i]]);
+        }
+    }
+}
+
+
+//the block before the first fence with at least the key is the earliest one that can hold it
+//...and the next fence is at least the key, so at most FENCE_SPACING words are walked
+int ClusteredSituations::firstAtLeast(uint32_t key, long& bytesTouched) const {
+    auto fence = lower_bound(fences.begin(), fences.end(), key);
+    //a binary search reads about log2 of the fences
+    long probes = 1;
+    for (size_t remaining = fences.size(); remaining > 1; remaining /= 2) {
+        probes++;
+    }
+    bytesTouched += probes * static_cast<long>(sizeof(uint32_t));
+
+    int block = max(0, static_cast<int>(fence - fences.begin()) - 1);
+    int position = block * FENCE_SPACING;
+    while (position < static_cast<int>(words.size()) && PackedSituations::situationKey(words[position]) < key) {
+        position++;
+        bytesTouched += static_cast<long>(sizeof(uint64_t));
+    }
+    return position;
+}
+
+
+//the quarter and down of a query are fixed, so every yard to go in the bounds is one run
+//...from its lowest yardLine and seconds up to its highest
+vector<SituationRun> ClusteredSituations::runs(uint64_t lower, uint64_t upper, long& bytesTouched) const {
+    vector<SituationRun> found;
+    uint32_t lowerKey = PackedSituations::situationKey(lower);
+    uint32_t upperKey = PackedSituations::situationKey(upper);
+    //toGo takes 7 bits of the key
+    uint32_t lowestToGo = (lowerKey >> PackedSituations::TO_GO_KEY_SHIFT) & 0x7F;
+    uint32_t highestToGo = (upperKey >> PackedSituations::TO_GO_KEY_SHIFT) & 0x7F;
+
+    for (uint32_t toGo = lowestToGo; toGo <= highestToGo; toGo++) {
+        uint32_t runLower = lowerKey + ((toGo - lowestToGo) << PackedSituations::TO_GO_KEY_SHIFT);
+        uint32_t runUpper = upperKey - ((highestToGo - toGo) << PackedSituations::TO_GO_KEY_SHIFT);
+        if (runLower > runUpper) {
+            continue;
+        }
+        SituationRun run;
+        run.begin = firstAtLeast(runLower, bytesTouched);
+        run.end = firstAtLeast(runUpper + 1, bytesTouched);
+        if (run.begin < run.end) {
+            found.push_back(run);
+        }
+    }
+    return found;
+}
+
+
+//the seasons and teams of the bounds are still checked on every word of the runs
+ClusteredScan ClusteredSituations::scan(const vector<SituationRun>& found, uint64_t lower, uint64_t upper) const {
+    ClusteredScan result;
+    result.runs = static_cast<int>(found.size());
+    for (const SituationRun& run : found) {
+        for (int i = run.begin; i < run.end; i++) {
+            if (PackedSituations::matches(words[i], lower, upper)) {
+                result.rows.push_back(rows[i]);
+            }
+        }
+        result.scannedRows += run.end - run.begin;
+    }
+    result.bytesTouched += result.scannedRows * static_cast<long>(sizeof(uint64_t))
+                           + static_cast<long>(result.rows.size() * sizeof(int));
+
+    //matches go back into heap order, so ties and everything built from them come out the same as a full scan
+    sort(result.rows.begin(), result.rows.end());
+    return result;
+}
+
+
+PackedTotals ClusteredSituations::aggregate(const SituationBounds& bounds) const {
+    PackedTotals totals;
+    uint64_t lower;
+    uint64_t upper;
+    if (!PackedSituations::packBounds(bounds, lower, upper)) {
+        return totals;
+    }
+    long bytesTouched = 0;
+    for (const SituationRun& run : runs(lower, upper, bytesTouched)) {
+        for (int i = run.begin; i < run.end; i++) {
+            PackedSituations::addOutcomes(totals, words[i], PackedSituations::matches(words[i], lower, upper) ? 1 : 0);
+        }
+    }
+    return totals;
+}
+
+
+long ClusteredSituations::runRows(const vector<SituationRun>& runs) {
+    long total = 0;
+    for (const SituationRun& run : runs) {
+        total += run.end - run.begin;
+    }
+    return total;
+}
+
+
+bool ClusteredSituations::empty() const {
+    return words.empty();
+}
+
+
+long ClusteredSituations::memoryBytes() const {
+    return static_cast<long>(words.capacity() * sizeof(uint64_t) + rows.capacity() * sizeof(int)
+                             + fences.capacity() * sizeof(uint32_t));
+}
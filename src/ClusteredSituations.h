@@ -0,0 +1,66 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+
+
+#include "PackedSituations.h"
+
+
+using namespace std;
+
+
+//a contiguous range of the clustered layout, from begin up to but not including end
+struct SituationRun {
+    int begin;
+    int end;
+};
+
+
+//what a scan of the clustered layout found and how much of the layout it read
+struct ClusteredScan {
+    //heap indices of the plays within the bounds, in heap order
+    vector<int> rows;
+    int runs = 0;
+    long scannedRows = 0;
+    //words and heap indices read, the fences and words read to find the runs are counted by runs
+    long bytesTouched = 0;
+};
+
+
+//the packed words of every play sorted by quarter, down, toGo, yardLine and seconds left, so similar situations sit next to each other
+//a query box is one contiguous run per yard to go, found through the key of every FENCE_SPACING-th word
+//plays with the same situation keep their heap order
+class ClusteredSituations {
+public:
+    static constexpr int FENCE_SPACING = 64;
+
+    //sorts the words of the heap, remembering the heap index of each
+    void build(const PackedSituations& packed);
+
+    //the runs holding every play within the packed bounds, bytesTouched counts the fences probed and words skipped to find them
+    vector<SituationRun> runs(uint64_t lower, uint64_t upper, long& bytesTouched) const;
+
+    //heap indices of the plays of the given runs within the bounds
+    ClusteredScan scan(const vector<SituationRun>& found, uint64_t lower, uint64_t upper) const;
+
+    //counts the plays within the bounds and their outcomes like PackedSituations::aggregate, only reading the runs
+    PackedTotals aggregate(const SituationBounds& bounds) const;
+
+    //amount of rows the runs hold
+    static long runRows(const vector<SituationRun>& runs);
+
+    bool empty() const;
+
+    //bytes held by the sorted words, heap indices and fences, for the memory report
+    long memoryBytes() const;
+
+private:
+    vector<uint64_t> words;
+    //heap index of each sorted word
+    vector<int> rows;
+    //situation key of words 0, FENCE_SPACING, 2*FENCE_SPACING...
+    vector<uint32_t> fences;
+
+    //position of the first word with at least the given key
+    int firstAtLeast(uint32_t key, long& bytesTouched) const;
+};
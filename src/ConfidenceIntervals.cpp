@@ -0,0 +1,151 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <random>
+
+
+#include "ConfidenceIntervals.h"
+#include "Helpers.h"
+#include "WorkerPool.h"
+
+
+using namespace std;
+
+
+//bootstraps the likelihoods of the matches on the worker pool, each task with its own random stream
+//every match is first reduced to a few bytes so a resample only draws indices and adds them up
+LikelihoodIntervals ConfidenceIntervals::compute(const vector<const Play*>& matches, const SuccessTally& tally,
+                                                 bool twoPointQuery, int latencyBudgetMs) {
+    vector<SubPlaySuccess> rankedPlays = tally.rankSubPlays();
+    int situations = static_cast<int>(matches.size());
+    if (situations == 0) {
+        return wilsonIntervals(tally, rankedPlays);
+    }
+
+    //statistic 0-3 are the likelihoods, the rest are the ranked sub plays
+    const int LIKELIHOODS = 4;
+    int statistics = LIKELIHOODS + static_cast<int>(rankedPlays.size());
+
+    //hits[match * statistics + statistic] is how many times the match counts toward the statistic
+    vector<uint8_t> hits(static_cast<size_t>(situations) * statistics, 0);
+    for (int i = 0; i < situations; i++) {
+        const Play& play = *matches[i];
+        uint8_t* matchHits = &hits[static_cast<size_t>(i) * statistics];
+        matchHits[0] = (play.outcomes & FIRST_DOWN_OUTCOME) ? 1 : 0;
+        matchHits[1] = (play.outcomes & TOUCHDOWN_OUTCOME) ? 1 : 0;
+        matchHits[2] = (play.outcomes & FIELD_GOAL_OUTCOME) ? 1 : 0;
+        matchHits[3] = (play.outcomes & TWO_POINT_OUTCOME) ? 1 : 0;
+
+        int cells[SuccessTally::MAX_SUCCESS_CELLS];
+        int cellCount = tally.successCells(play, twoPointQuery, cells);
+        for (int c = 0; c < cellCount; c++) {
+            for (int r = 0; r < static_cast<int>(rankedPlays.size()); r++) {
+                if (cells[c] == rankedPlays[r].playTypeCode * PlayDictionary::MAX_SUB_TYPES + rankedPlays[r].subTypeCode) {
+                    matchHits[LIKELIHOODS + r]++;
+                }
+            }
+        }
+    }
+
+    //rates[statistic * RESAMPLES + resample]
+    vector<float> rates(static_cast<size_t>(statistics) * RESAMPLES);
+    auto resample = [&](int resampleIndex, mt19937& random) {
+        uniform_int_distribution<int> pick(0, situations - 1);
+        vector<int> sums(statistics, 0);
+        for (int draw = 0; draw < situations; draw++) {
+            const uint8_t* matchHits = &hits[static_cast<size_t>(pick(random)) * statistics];
+            for (int statistic = 0; statistic < statistics; statistic++) {
+                sums[statistic] += matchHits[statistic];
+            }
+        }
+        for (int statistic = 0; statistic < statistics; statistic++) {
+            rates[static_cast<size_t>(statistic) * RESAMPLES + resampleIndex] = static_cast<float>(sums[statistic]) / situations * 100;
+        }
+    };
+
+    //times a few resamples on this thread to estimate whether the rest fits in the budget
+    const int PILOT_RESAMPLES = 8;
+    auto start = chrono::steady_clock::now();
+    mt19937 pilotRandom(RESAMPLES);
+    for (int i = 0; i < PILOT_RESAMPLES; i++) {
+        resample(i, pilotRandom);
+    }
+    double pilotMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    double estimatedMs = pilotMs / PILOT_RESAMPLES * (RESAMPLES - PILOT_RESAMPLES) / WorkerPool::shared().size();
+    if (pilotMs + estimatedMs > latencyBudgetMs) {
+        return wilsonIntervals(tally, rankedPlays);
+    }
+
+    //tasks are seeded by their index so the intervals are the same for any amount of threads
+    const int RESAMPLES_PER_TASK = 64;
+    int remaining = RESAMPLES - PILOT_RESAMPLES;
+    int tasks = (remaining + RESAMPLES_PER_TASK - 1) / RESAMPLES_PER_TASK;
+    WorkerPool::shared().parallelFor(tasks, [&](int task) {
+        mt19937 random(static_cast<unsigned int>(task));
+        int first = PILOT_RESAMPLES + task*RESAMPLES_PER_TASK;
+        int last = min(RESAMPLES, first + RESAMPLES_PER_TASK);
+        for (int i = first; i < last; i++) {
+            resample(i, random);
+        }
+    });
+
+    //percentile intervals of every statistic
+    vector<Interval> intervals(statistics);
+    for (int statistic = 0; statistic < statistics; statistic++) {
+        auto begin = rates.begin() + static_cast<long>(statistic) * RESAMPLES;
+        sort(begin, begin + RESAMPLES);
+        intervals[statistic].low = *(begin + static_cast<int>(RESAMPLES * 0.025));
+        intervals[statistic].high = *(begin + static_cast<int>(RESAMPLES * 0.975) - 1);
+    }
+
+    LikelihoodIntervals result;
+    result.method = "BOOTSTRAP";
+    result.resamples = RESAMPLES;
+    result.firstDown = intervals[0];
+    result.touchdown = intervals[1];
+    result.fieldGoal = intervals[2];
+    result.twoPoint = intervals[3];
+    result.subPlays.assign(intervals.begin() + LIKELIHOODS, intervals.end());
+    return result;
+}
+
+
+LikelihoodIntervals ConfidenceIntervals::wilsonIntervals(const SuccessTally& tally, const vector<SubPlaySuccess>& rankedPlays) {
+    LikelihoodIntervals result;
+    result.method = "WILSON";
+    result.firstDown = wilson(tally.firstDowns, tally.situations);
+    result.touchdown = wilson(tally.touchdowns, tally.situations);
+    result.fieldGoal = wilson(tally.fieldGoals, tally.situations);
+    result.twoPoint = wilson(tally.conversions, tally.situations);
+    for (const SubPlaySuccess& successfulPlay : rankedPlays) {
+        result.subPlays.push_back(wilson(successfulPlay.successes, tally.situations));
+    }
+    return result;
+}
+
+
+//analytic interval of a proportion that stays within 0-100% even for small samples
+Interval ConfidenceIntervals::wilson(int successes, int situations) {
+    Interval interval;
+    if (situations <= 0) {
+        return interval;
+    }
+
+    const double z = 1.96;
+    double n = situations;
+    //a play can count twice toward a sub play, so the proportion is capped at 1
+    double p = min(1.0, successes / n);
+    double denominator = 1 + z*z/n;
+    double center = (p + z*z/(2*n)) / denominator;
+    double halfWidth = z * sqrt(p*(1 - p)/n + z*z/(4*n*n)) / denominator;
+    interval.low = static_cast<float>(max(0.0, center - halfWidth) * 100);
+    interval.high = static_cast<float>(min(1.0, center + halfWidth) * 100);
+    return interval;
+}
+
+
+//formats an interval like " (95% CI 30.12-55.00%)"
+string ConfidenceIntervals::format(const Interval& interval) {
+    return " (95% CI " + Helpers::formatPercentages(interval.low) + "-" + Helpers::formatPercentages(interval.high) + "%)";
+}
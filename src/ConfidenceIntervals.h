@@ -0,0 +1,51 @@
+#pragma once
+#include <string>
+#include <vector>
+
+
+#include "Play.h"
+#include "SuccessTally.h"
+
+
+using namespace std;
+
+
+//95% interval of a likelihood in percent
+struct Interval {
+    float low = 0.0f;
+    float high = 0.0f;
+};
+
+
+//intervals of every likelihood printed for a query
+struct LikelihoodIntervals {
+    //"BOOTSTRAP" or "WILSON"
+    string method;
+    int resamples = 0;
+    Interval firstDown;
+    Interval touchdown;
+    Interval fieldGoal;
+    Interval twoPoint;
+    //in the same order as SuccessTally::rankSubPlays
+    vector<Interval> subPlays;
+};
+
+
+class ConfidenceIntervals {
+public:
+    static constexpr int RESAMPLES = 2000;
+
+    //bootstraps the likelihoods of the matches on the worker pool, each task with its own random stream
+    //uses Wilson intervals instead if the resampling is estimated to take longer than the latency budget
+    static LikelihoodIntervals compute(const vector<const Play*>& matches, const SuccessTally& tally, bool twoPointQuery,
+                                       int latencyBudgetMs);
+
+    //analytic interval of a proportion that stays within 0-100% even for small samples
+    static Interval wilson(int successes, int situations);
+
+    //formats an interval like " (95% CI 30.12-55.00%)"
+    static string format(const Interval& interval);
+
+private:
+    static LikelihoodIntervals wilsonIntervals(const SuccessTally& tally, const vector<SubPlaySuccess>& rankedPlays);
+};
@@ -0,0 +1,167 @@
+#include <sstream>
+#include <algorithm>
+#include <iterator>
+#include <chrono>
+
+
+#include "DatasetSnapshot.h"
+
+
+using namespace std;
+
+
+atomic<long> Dataset::live{0};
+mutex Dataset::expectedPointsMutex;
+
+
+Dataset::Dataset() {
+    live++;
+}
+
+
+Dataset::~Dataset() {
+    table.release(hashTable);
+    live--;
+}
+
+
+void Dataset::separatePunts(vector<Play>& plays) {
+    auto firstPunt = stable_partition(plays.begin(), plays.end(), [](const Play& play) {
+        return !play.isPunt;
+    });
+    if (punts.empty()) {
+        punts.assign(make_move_iterator(firstPunt), make_move_iterator(plays.end()));
+    }
+    plays.erase(firstPunt, plays.end());
+}
+
+
+void Dataset::buildHeap(vector<Play>& plays, const DatasetOptions& options, ostream& log) {
+    separatePunts(plays);
+    maxHeap.build(plays);
+    if (options.nearestNeighbors) {
+        maxHeap.indexNeighbors();
+    }
+    if (options.windowCounts) {
+        maxHeap.indexCounts();
+    }
+    if (options.textIndex) {
+        maxHeap.indexText();
+        const DescriptionIndex& textIndex = maxHeap.getTextIndex();
+        log << "Indexed " << textIndex.termCount() << " description words into " << textIndex.postingBytes()
+            << " bytes of posting lists, " << textIndex.memoryBytes() << " bytes in all, against "
+            << textIndex.textBytes() << " bytes of descriptions\n";
+    }
+    buildShared(maxHeap.playPointers(), options, log);
+    log << "Situations packed into " << maxHeap.getPacked().bytesPerPlay() << " bytes per play\n";
+    heapBuilt = true;
+}
+
+
+//the drive transitions, expected points and game sequences only need plays, so they are built once from either data structure
+void Dataset::buildShared(const vector<const Play*>& plays, const DatasetOptions& options, ostream& log) {
+    if (options.sequences && sequences.empty()) {
+        sequences.build(plays);
+        log << "Reconstructed " << sequences.gameCount() << " games and " << sequences.driveCount() << " drives\n";
+    }
+    //drives also end with punts, which only the transitions and expected points read
+    vector<const Play*> drivePlays = plays;
+    for (const Play& punt : punts) {
+        drivePlays.push_back(&punt);
+    }
+    if (options.driveTransitions && driveTransitions.empty()) {
+        driveTransitions.build(drivePlays);
+    }
+    //a reload means the data changed, so the table is solved again instead of loaded
+    if (!options.expectedPointsFile.empty() && expectedPoints.empty()
+        && (generation > 0 || !expectedPoints.load(options.expectedPointsFile))) {
+        expectedPoints.solve(drivePlays, log);
+        lock_guard<mutex> lock(expectedPointsMutex);
+        expectedPoints.save(options.expectedPointsFile);
+    }
+}
+
+
+void Dataset::buildHashTable(vector<Play>& plays, const DatasetOptions& options, ostream& log) {
+    separatePunts(plays);
+    PlayHashTable::pushIntoHashMap(plays, hashTable);
+    if (options.nearestNeighbors) {
+        table.indexNeighbors(hashTable);
+    }
+    if (options.windowCounts) {
+        table.indexCounts(hashTable);
+    }
+    buildShared(PlayHashTable::playPointers(hashTable), options, log);
+    hashTableBuilt = true;
+}
+
+
+shared_ptr<Dataset> Dataset::load(const string& path, const IngestConfig& config, const DatasetOptions& options,
+                                  long generation, bool withHeap, bool withHashTable) {
+    auto start = chrono::steady_clock::now();
+    shared_ptr<Dataset> dataset = make_shared<Dataset>();
+    dataset->generation = generation;
+
+    vector<Play> plays;
+    dataset->stats = PlayIngest::readFiles(PlayIngest::listDataFiles(path), config, plays);
+    ostringstream log;
+    if (withHashTable) {
+        vector<Play> hashTablePlays = PlayIngest::takeHashTablePlays(plays, withHeap);
+        dataset->buildHashTable(hashTablePlays, options, log);
+    }
+    if (withHeap) {
+        dataset->buildHeap(plays, options, log);
+    }
+
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    log << "Reloaded the data in " << seconds << " seconds\n";
+    dataset->report = log.str();
+    return dataset;
+}
+
+
+long Dataset::liveCount() {
+    return live.load();
+}
+
+
+DatasetStore::~DatasetStore() {
+    if (reloader.joinable()) {
+        reloader.join();
+    }
+}
+
+
+shared_ptr<Dataset> DatasetStore::current() const {
+    return atomic_load(&active);
+}
+
+
+void DatasetStore::publish(shared_ptr<Dataset> dataset) {
+    atomic_store(&active, std::move(dataset));
+}
+
+
+bool DatasetStore::reloadInBackground(const string& path, const IngestConfig& config, const DatasetOptions& options,
+                                      bool withHeap, bool withHashTable) {
+    bool expected = false;
+    if (!reloadRunning.compare_exchange_strong(expected, true)) {
+        return false;
+    }
+    //the previous reload already finished, since reloadRunning was false
+    if (reloader.joinable()) {
+        reloader.join();
+    }
+
+    long generation = nextGeneration++;
+    reloader = thread([this, path, config, options, generation, withHeap, withHashTable] {
+        publish(Dataset::load(path, config, options, generation, withHeap, withHashTable));
+        reloadRunning = false;
+    });
+    return true;
+}
+
+
+bool DatasetStore::reloading() const {
+    return reloadRunning.load();
+}
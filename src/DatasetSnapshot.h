@@ -0,0 +1,113 @@
+#pragma once
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <mutex>
+
+
+#include "PlayMaxHeap.h"
+#include "PlayHashTable.h"
+#include "DriveSimulator.h"
+#include "ExpectedPoints.h"
+#include "GameSequences.h"
+
+
+using namespace std;
+
+
+//what a dataset builds next to the data structures, from the command line options
+struct DatasetOptions {
+    bool nearestNeighbors = false;
+    bool windowCounts = false;
+    bool driveTransitions = false;
+    bool textIndex = false;
+    bool sequences = false;
+    //loaded from the file by the first dataset, solved and written to it by later ones
+    string expectedPointsFile;
+};
+
+
+//every data structure built from one read of the data
+//it is published as a whole, so a query never mixes plays from two reads
+struct Dataset {
+    long generation = 0;
+    IngestStats stats;
+    //what the build reported, printed once the dataset is first used
+    string report;
+
+    PlayMaxHeap maxHeap;
+    vector<LinkedList> hashTable = vector<LinkedList>(500);
+    PlayHashTable table = PlayHashTable(500);
+    bool heapBuilt = false;
+    bool hashTableBuilt = false;
+
+    //punts read for the drives, kept out of both data structures since no query suggests them
+    vector<Play> punts;
+    DriveTransitions driveTransitions;
+    ExpectedPointsTable expectedPoints;
+    //plays in game order, built from whichever data structure is built first like the drive transitions
+    GameSequences sequences;
+
+    Dataset();
+
+    Dataset(const Dataset&) = delete;
+
+    Dataset& operator=(const Dataset&) = delete;
+
+    //deletes the plays of the hash table
+    ~Dataset();
+
+    //builds the heap and the indexes used with it from parsed plays
+    void buildHeap(vector<Play>& plays, const DatasetOptions& options, ostream& log);
+
+    //builds the indexes shared by both data structures if they aren't built yet
+    void buildShared(const vector<const Play*>& plays, const DatasetOptions& options, ostream& log);
+
+    //builds the hash table and the indexes used with it from parsed plays
+    void buildHashTable(vector<Play>& plays, const DatasetOptions& options, ostream& log);
+
+    //reads the data once and builds the asked for data structures from it, for reloads
+    static shared_ptr<Dataset> load(const string& path, const IngestConfig& config, const DatasetOptions& options,
+                                    long generation, bool withHeap, bool withHashTable);
+
+    //datasets that haven't been freed yet, old ones stay alive until the queries using them finish
+    static long liveCount();
+
+private:
+    static atomic<long> live;
+
+    //moves the punts out of parsed plays before a data structure takes them, the first build keeps them
+    void separatePunts(vector<Play>& plays);
+
+    //a reload can solve the expected points while the first dataset still builds, only one of them writes the file at a time
+    static mutex expectedPointsMutex;
+};
+
+
+//holds the dataset queries use, like read-copy-update
+//a query takes a reference to the current dataset without waiting on anything
+//a reload builds a whole new dataset on a background thread and swaps it in with a single atomic store
+//the old dataset is freed when the last query holding a reference to it finishes
+class DatasetStore {
+public:
+    ~DatasetStore();
+
+    shared_ptr<Dataset> current() const;
+
+    void publish(shared_ptr<Dataset> dataset);
+
+    //reads and builds a new dataset on a background thread and publishes it, false if a reload is already running
+    bool reloadInBackground(const string& path, const IngestConfig& config, const DatasetOptions& options,
+                            bool withHeap, bool withHashTable);
+
+    bool reloading() const;
+
+private:
+    shared_ptr<Dataset> active;
+    thread reloader;
+    atomic<bool> reloadRunning{false};
+    atomic<long> nextGeneration{1};
+};
@@ -0,0 +1,62 @@
+#include <cctype>
+#include <algorithm>
+
+
+#include "DescriptionFeatures.h"
+
+
+using namespace std;
+
+
+//string_view::find looks for the first character with memchr, so a phrase that isn't there costs about one pass over the text
+bool DescriptionFeatures::mentions(string_view text, string_view phrase) {
+    return text.find(phrase) != string_view::npos;
+}
+
+
+int DescriptionFeatures::numberBefore(string_view text, size_t position) {
+    size_t start = position;
+    while (start > 0 && isdigit(static_cast<unsigned char>(text[start - 1]))) {
+        start--;
+    }
+    int number = 0;
+    for (size_t i = start; i < position && number < 1000; i++) {
+        number = number*10 + (text[i] - '0');
+    }
+    return number;
+}
+
+
+//"IS GOOD" is checked before "IS NO GOOD" so a description mentioning both counts as good, like the substring search it replaces
+void DescriptionFeatures::extract(string_view description, Play& play) {
+    if (mentions(description, "IS GOOD")) {
+        play.kickResult = KICK_GOOD;
+    }
+    else if (mentions(description, "IS NO GOOD")) {
+        play.kickResult = KICK_MISSED;
+    }
+    else if (mentions(description, "BLOCKED") && (mentions(description, "FIELD GOAL") || mentions(description, "EXTRA POINT"))) {
+        play.kickResult = KICK_BLOCKED;
+    }
+    size_t fieldGoal = description.find(" YARD FIELD GOAL");
+    if (fieldGoal != string_view::npos) {
+        play.kickDistance = static_cast<unsigned char>(min(numberBefore(description, fieldGoal), 255));
+    }
+
+    //the pass or rush of a two point conversion is only in the description
+    if (play.isTwoPointConversion || mentions(description, "TWO-POINT CONVERSION")) {
+        if (mentions(description, "PASS")) {
+            play.twoPointMethod = TWO_POINT_PASS;
+        }
+        else if (mentions(description, "RUSH")) {
+            play.twoPointMethod = TWO_POINT_RUSH;
+        }
+    }
+
+    if (mentions(description, "PENALTY")) {
+        play.penaltyFlags |= PENALTY_FLAG;
+        if (mentions(description, "DECLINED")) play.penaltyFlags |= PENALTY_DECLINED;
+        if (mentions(description, "OFFSETTING")) play.penaltyFlags |= PENALTY_OFFSETTING;
+        if (mentions(description, "NULLIFIED")) play.penaltyFlags |= PLAY_NULLIFIED;
+    }
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include <string_view>
+
+
+#include "Play.h"
+
+
+using namespace std;
+
+
+//parses the description of a play once at ingest into typed columns, so no query ever searches the text
+//runs inside PlayIngest::parseLine, so every file is parsed in parallel on the worker pool
+//descriptions look like "(14:51) (SHOTGUN) 11-J.FLACCO PASS SHORT RIGHT TO 89-S.SMITH ... PENALTY ON DEN-C.HARRIS, HOLDING"
+//...or "J.TUCKER 31 YARD FIELD GOAL IS GOOD" or "TWO-POINT CONVERSION ATTEMPT. P.MAHOMES RUSH. ATTEMPT SUCCEEDS"
+class DescriptionFeatures {
+public:
+    //fills in the kick, two point and penalty columns of a play from its description
+    //the two point method is only filled in for two point conversions, so it needs the columns read first
+    static void extract(string_view description, Play& play);
+
+private:
+    static bool mentions(string_view text, string_view phrase);
+
+    //the number that ends right before the given position, like the 31 of "31 YARD FIELD GOAL", 0 if there is none
+    static int numberBefore(string_view text, size_t position);
+};
@@ -0,0 +1,183 @@
+#include <algorithm>
+#include <cctype>
+
+
+#include "DescriptionIndex.h"
+
+
+using namespace std;
+
+
+namespace {
+    //dots and apostrophes stay inside words so names like J.FLACCO and O'CONNELL are kept whole
+    bool isWordChar(char c) {
+        return isalnum(static_cast<unsigned char>(c)) || c == '.' || c == '\'';
+    }
+}
+
+
+vector<string_view> DescriptionIndex::tokenize(string_view text, string& uppercase) {
+    uppercase.assign(text.begin(), text.end());
+    for (char& c : uppercase) {
+        c = static_cast<char>(toupper(static_cast<unsigned char>(c)));
+    }
+    string_view upper(uppercase);
+
+    size_t i = 0;
+    if (upper.size() > 1 && upper[0] == '(' && isdigit(static_cast<unsigned char>(upper[1]))) {
+        size_t close = upper.find(')');
+        i = close == string_view::npos ? upper.size() : close + 1;
+    }
+
+    vector<string_view> words;
+    while (i < upper.size()) {
+        while (i < upper.size() && !isWordChar(upper[i])) {
+            i++;
+        }
+        size_t start = i;
+        while (i < upper.size() && isWordChar(upper[i])) {
+            i++;
+        }
+        //a dot at the end of a word ends a sentence, like "PASS." in "P.MAHOMES PASS. ATTEMPT FAILS"
+        size_t end = i;
+        while (end > start && upper[end - 1] == '.') {
+            end--;
+        }
+        if (end > start) {
+            words.push_back(upper.substr(start, end - start));
+        }
+    }
+    return words;
+}
+
+
+//7 bits of the gap per byte, the high bit is set on every byte but the last
+void DescriptionIndex::appendGap(vector<uint8_t>& list, int gap) {
+    uint32_t value = static_cast<uint32_t>(gap);
+    while (value >= 0x80) {
+        list.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    list.push_back(static_cast<uint8_t>(value));
+}
+
+
+//rows are visited in order, so every list is built already sorted and a word used twice by one play is only added once
+void DescriptionIndex::build(const vector<Play>& plays) {
+    terms.clear();
+    indexedTextBytes = 0;
+    vector<vector<uint8_t>> lists;
+    vector<int> lastRows;
+    postingCounts.clear();
+
+    string uppercase;
+    for (int row = 0; row < static_cast<int>(plays.size()); row++) {
+        indexedTextBytes += static_cast<long>(plays[row].description.size());
+        for (string_view word : tokenize(plays[row].description, uppercase)) {
+            auto found = terms.find(string(word));
+            if (found == terms.end()) {
+                found = terms.insert({string(word), static_cast<int>(lists.size())}).first;
+                lists.emplace_back();
+                lastRows.push_back(-1);
+                postingCounts.push_back(0);
+            }
+            int term = found->second;
+            if (lastRows[term] == row) {
+                continue;
+            }
+            appendGap(lists[term], row - lastRows[term] - 1);
+            lastRows[term] = row;
+            postingCounts[term]++;
+        }
+    }
+
+    //every list goes into one array, so the index is a few allocations instead of one per word
+    postings.clear();
+    postingStarts.assign(1, 0);
+    for (const vector<uint8_t>& list : lists) {
+        postings.insert(postings.end(), list.begin(), list.end());
+        postingStarts.push_back(static_cast<uint32_t>(postings.size()));
+    }
+    postings.shrink_to_fit();
+}
+
+
+vector<int> DescriptionIndex::decode(int term) const {
+    vector<int> rows;
+    rows.reserve(postingCounts[term]);
+    int row = -1;
+    uint32_t position = postingStarts[term];
+    while (position < postingStarts[term + 1]) {
+        uint32_t gap = 0;
+        int shift = 0;
+        while (postings[position] & 0x80) {
+            gap |= static_cast<uint32_t>(postings[position++] & 0x7F) << shift;
+            shift += 7;
+        }
+        gap |= static_cast<uint32_t>(postings[position++]) << shift;
+        row += static_cast<int>(gap) + 1;
+        rows.push_back(row);
+    }
+    return rows;
+}
+
+
+//the rarest word is decoded first, so every later intersection can only shrink it
+vector<int> DescriptionIndex::matchingRows(const string& keywords) const {
+    string uppercase;
+    vector<int> wordTerms;
+    for (string_view word : tokenize(keywords, uppercase)) {
+        auto found = terms.find(string(word));
+        if (found == terms.end()) {
+            return {};
+        }
+        wordTerms.push_back(found->second);
+    }
+    if (wordTerms.empty()) {
+        return {};
+    }
+    sort(wordTerms.begin(), wordTerms.end(), [this](int a, int b) {
+        return postingCounts[a] < postingCounts[b];
+    });
+
+    vector<int> rows = decode(wordTerms[0]);
+    for (int i = 1; i < static_cast<int>(wordTerms.size()) && !rows.empty(); i++) {
+        vector<int> other = decode(wordTerms[i]);
+        vector<int> both;
+        set_intersection(rows.begin(), rows.end(), other.begin(), other.end(), back_inserter(both));
+        rows = std::move(both);
+    }
+    return rows;
+}
+
+
+bool DescriptionIndex::empty() const {
+    return terms.empty();
+}
+
+
+int DescriptionIndex::termCount() const {
+    return static_cast<int>(terms.size());
+}
+
+
+long DescriptionIndex::textBytes() const {
+    return indexedTextBytes;
+}
+
+
+long DescriptionIndex::postingBytes() const {
+    return static_cast<long>(postings.capacity());
+}
+
+
+//counts each word once as a key, its node in the map, and its posting start and count
+long DescriptionIndex::memoryBytes() const {
+    long bytes = postingBytes() + static_cast<long>(postingStarts.capacity() * sizeof(uint32_t)
+                                                   + postingCounts.capacity() * sizeof(int)
+                                                   + terms.bucket_count() * sizeof(void*));
+    for (const auto& term : terms) {
+        bytes += static_cast<long>(sizeof(string) + sizeof(int) + sizeof(void*) + term.first.size());
+    }
+    return bytes;
+}
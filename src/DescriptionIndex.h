@@ -0,0 +1,55 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+
+#include "Play.h"
+
+
+using namespace std;
+
+
+//an inverted index from every word of the play descriptions to the rows of the plays that use it
+//each posting list is the sorted rows stored as varint-encoded gaps, so common words like SHOTGUN take about a byte per play
+//a keyword query intersects the lists of its words, smallest first, and the caller checks the rows against the situation
+class DescriptionIndex {
+public:
+    //indexes the descriptions of the plays, rows are positions in the vector
+    void build(const vector<Play>& plays);
+
+    //rows of the plays whose descriptions use every word of the keywords, in ascending order
+    //words don't have to be next to each other, so "DEEP LEFT" matches every play with both DEEP and LEFT
+    vector<int> matchingRows(const string& keywords) const;
+
+    //splits a description or keywords into uppercase words, dropping the leading clock like "(14:51)"
+    //names like "J.FLACCO" stay one word, jersey numbers like the 11 of "11-J.FLACCO" become their own
+    static vector<string_view> tokenize(string_view text, string& uppercase);
+
+    bool empty() const;
+
+    int termCount() const;
+
+    //bytes of the descriptions that were indexed
+    long textBytes() const;
+
+    //bytes of the posting lists alone and of everything the index holds, for the memory report
+    long postingBytes() const;
+
+    long memoryBytes() const;
+
+private:
+    unordered_map<string, int> terms;
+    //the posting list of term t is postings[postingStarts[t]] up to postings[postingStarts[t + 1]]
+    vector<uint8_t> postings;
+    vector<uint32_t> postingStarts;
+    vector<int> postingCounts;
+    long indexedTextBytes = 0;
+
+    //appends a row to a posting list under construction as the gap from the previous row
+    static void appendGap(vector<uint8_t>& list, int gap);
+
+    vector<int> decode(int term) const;
+};
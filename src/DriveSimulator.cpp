@@ -0,0 +1,261 @@
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+
+
+#include "DriveSimulator.h"
+#include "PlayDictionary.h"
+#include "Helpers.h"
+#include "WorkerPool.h"
+
+
+using namespace std;
+
+
+//1, 2, 3, 4-6, 7-10, 11-15, and 16 or more yards to go
+int DriveTransitions::toGoBucket(int toGo) {
+    if (toGo <= 3) {
+        return max(toGo, 1) - 1;
+    }
+    if (toGo <= 6) {
+        return 3;
+    }
+    if (toGo <= 10) {
+        return 4;
+    }
+    if (toGo <= 15) {
+        return 5;
+    }
+    return 6;
+}
+
+
+int DriveTransitions::stateOf(int down, int toGo, int yardLine) {
+    if (down < 1 || down > DOWNS) {
+        return -1;
+    }
+    int yardLineBucket = min(max(yardLine, 0) / 10, YARD_LINE_BUCKETS - 1);
+    return ((down - 1)*TO_GO_BUCKETS + toGoBucket(toGo))*YARD_LINE_BUCKETS + yardLineBucket;
+}
+
+
+DriveStep DriveTransitions::stepOf(const Play& play) {
+    static const int FIELD_GOAL_CODE = PlayDictionary::encode(PlayDictionary::PLAY_TYPE, "FIELD GOAL");
+
+    DriveStep step;
+    step.yards = static_cast<short>(play.resultingYards);
+    step.flags = 0;
+    if (play.resultIsFirstDown) step.flags |= DriveStep::FIRST_DOWN;
+    if (play.isTouchdown) step.flags |= DriveStep::TOUCHDOWN;
+    if (play.isInterception || play.isFumble) step.flags |= DriveStep::TURNOVER;
+    if (play.isPunt) step.flags |= DriveStep::PUNT;
+    if (play.playTypeCode == FIELD_GOAL_CODE) {
+        step.flags |= DriveStep::FIELD_GOAL_ATTEMPT;
+        if (play.outcomes & FIELD_GOAL_OUTCOME) step.flags |= DriveStep::FIELD_GOAL_GOOD;
+    }
+    return step;
+}
+
+
+//groups the steps by fine state, by down and field position, and by down with counting sorts
+void DriveTransitions::build(const vector<const Play*>& plays) {
+    const int FIELD_STATES = DOWNS * YARD_LINE_BUCKETS;
+    //offsets of the three groupings in one array of counts
+    const int FINE = 0;
+    const int FIELD = STATES;
+    const int DOWN = STATES + FIELD_STATES;
+    vector<int> groupStarts(DOWN + DOWNS + 1, 0);
+
+    auto groupsOf = [&](int state, int groups[3]) {
+        int down = state / (TO_GO_BUCKETS * YARD_LINE_BUCKETS);
+        groups[0] = FINE + state;
+        groups[1] = FIELD + down*YARD_LINE_BUCKETS + state % YARD_LINE_BUCKETS;
+        groups[2] = DOWN + down;
+    };
+
+    for (const Play* play : plays) {
+        int state = stateOf(play->down, play->toGo, play->yardLine);
+        if (state == -1) {
+            continue;
+        }
+        int groups[3];
+        groupsOf(state, groups);
+        for (int group : groups) {
+            groupStarts[group + 1]++;
+        }
+    }
+    for (int group = 1; group < static_cast<int>(groupStarts.size()); group++) {
+        groupStarts[group] += groupStarts[group - 1];
+    }
+
+    steps.resize(groupStarts.back());
+    vector<int> nextSlot(groupStarts.begin(), groupStarts.end() - 1);
+    for (const Play* play : plays) {
+        int state = stateOf(play->down, play->toGo, play->yardLine);
+        if (state == -1) {
+            continue;
+        }
+        DriveStep step = stepOf(*play);
+        int groups[3];
+        groupsOf(state, groups);
+        for (int group : groups) {
+            steps[nextSlot[group]++] = step;
+        }
+    }
+
+    //every fine state samples from the first grouping with enough plays
+    starts.assign(STATES, 0);
+    counts.assign(STATES, 0);
+    for (int state = 0; state < STATES; state++) {
+        int groups[3];
+        groupsOf(state, groups);
+        for (int group : groups) {
+            starts[state] = groupStarts[group];
+            counts[state] = groupStarts[group + 1] - groupStarts[group];
+            if (counts[state] >= MIN_SAMPLES) {
+                break;
+            }
+        }
+    }
+}
+
+
+bool DriveTransitions::empty() const {
+    return steps.empty();
+}
+
+
+int DriveTransitions::sampleStart(int state) const {
+    return starts[state];
+}
+
+
+int DriveTransitions::sampleCount(int state) const {
+    return counts[state];
+}
+
+
+const DriveStep& DriveTransitions::step(int index) const {
+    return steps[index];
+}
+
+
+uint64_t DriveSimulator::nextRandom(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+
+//plays out drives from the situation on the worker pool, each task with its own random stream and counts
+//a drive samples a historical play of its current state until it scores, punts, turns the ball over, or gives a safety
+DriveOutlook DriveSimulator::simulate(const DriveTransitions& transitions, const Play& currentSituation, long drives) {
+    DriveOutlook outlook;
+    if (transitions.empty() || DriveTransitions::stateOf(currentSituation.down, currentSituation.toGo, currentSituation.yardLine) == -1) {
+        return outlook;
+    }
+
+    auto start = chrono::steady_clock::now();
+
+    const long DRIVES_PER_TASK = 65536;
+    int tasks = static_cast<int>((drives + DRIVES_PER_TASK - 1) / DRIVES_PER_TASK);
+    vector<DriveOutlook> taskOutlooks(tasks);
+
+    WorkerPool::shared().parallelFor(tasks, [&](int task) {
+        DriveOutlook local;
+        uint64_t random = static_cast<uint64_t>(task) + 1;
+        long taskDrives = min(DRIVES_PER_TASK, drives - task*DRIVES_PER_TASK);
+
+        for (long drive = 0; drive < taskDrives; drive++) {
+            int down = currentSituation.down;
+            int toGo = currentSituation.toGo;
+            int yardLine = currentSituation.yardLine;
+            DriveResult result = TURNOVER_DRIVE;
+
+            for (int playNumber = 0; playNumber < MAX_DRIVE_PLAYS; playNumber++) {
+                int state = DriveTransitions::stateOf(down, toGo, yardLine);
+                int count = transitions.sampleCount(state);
+                if (count == 0) {
+                    break;
+                }
+                //scales 32 random bits to the amount of steps without a division
+                uint64_t pick = ((nextRandom(random) >> 32) * static_cast<uint64_t>(count)) >> 32;
+                const DriveStep& step = transitions.step(transitions.sampleStart(state) + static_cast<int>(pick));
+                local.plays++;
+
+                if (step.flags & DriveStep::TURNOVER) {
+                    break;
+                }
+                if (step.flags & DriveStep::PUNT) {
+                    result = PUNT_DRIVE;
+                    break;
+                }
+                if (step.flags & DriveStep::FIELD_GOAL_ATTEMPT) {
+                    result = (step.flags & DriveStep::FIELD_GOAL_GOOD) ? FIELD_GOAL_DRIVE : TURNOVER_DRIVE;
+                    break;
+                }
+
+                yardLine += step.yards;
+                if ((step.flags & DriveStep::TOUCHDOWN) || yardLine >= 100) {
+                    result = TOUCHDOWN_DRIVE;
+                    break;
+                }
+                if (yardLine <= 0) {
+                    result = SAFETY_DRIVE;
+                    break;
+                }
+
+                if ((step.flags & DriveStep::FIRST_DOWN) || step.yards >= toGo) {
+                    down = 1;
+                    toGo = min(10, 100 - yardLine);
+                }
+                else {
+                    down++;
+                    toGo -= step.yards;
+                    //turnover on downs
+                    if (down > DriveTransitions::DOWNS) {
+                        break;
+                    }
+                }
+            }
+            local.results[result]++;
+        }
+        local.drives = taskDrives;
+        taskOutlooks[task] = local;
+    });
+
+    for (const DriveOutlook& taskOutlook : taskOutlooks) {
+        outlook.drives += taskOutlook.drives;
+        outlook.plays += taskOutlook.plays;
+        for (int result = 0; result < DRIVE_RESULTS; result++) {
+            outlook.results[result] += taskOutlook.results[result];
+        }
+    }
+    outlook.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return outlook;
+}
+
+
+void DriveOutlook::print() const {
+    if (drives == 0) {
+        return;
+    }
+
+    auto percent = [&](DriveResult result) {
+        return Helpers::formatPercentages(static_cast<float>(results[result]) / static_cast<float>(drives) * 100);
+    };
+    cout << "DRIVE OUTLOOK (" << drives << " simulated drives in " << seconds << " seconds, ";
+    cout << static_cast<long>(drives / max(seconds, 1e-9) / 1000000) << " million per second):\n";
+    cout << "    Touchdown: " << percent(TOUCHDOWN_DRIVE) << "%\n";
+    cout << "    Field Goal: " << percent(FIELD_GOAL_DRIVE) << "%\n";
+    cout << "    Punt: " << percent(PUNT_DRIVE) << "%\n";
+    cout << "    Turnover: " << percent(TURNOVER_DRIVE) << "%\n";
+    cout << "    Safety: " << percent(SAFETY_DRIVE) << "%\n";
+    cout << "    Plays per drive: " << static_cast<float>(plays) / static_cast<float>(drives) << "\n\n";
+}
+
+
+long DriveTransitions::memoryBytes() const {
+    return static_cast<long>(steps.capacity() * sizeof(DriveStep) + (starts.capacity() + counts.capacity()) * sizeof(int));
+}
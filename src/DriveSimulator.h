@@ -0,0 +1,103 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+
+
+#include "Play.h"
+
+
+using namespace std;
+
+
+//what happened on one historical play, all the simulator needs to replay it
+struct DriveStep {
+    short yards;
+    unsigned char flags;
+
+    static constexpr unsigned char FIRST_DOWN = 1;
+    static constexpr unsigned char TOUCHDOWN = 2;
+    static constexpr unsigned char TURNOVER = 4;
+    static constexpr unsigned char FIELD_GOAL_ATTEMPT = 8;
+    static constexpr unsigned char FIELD_GOAL_GOOD = 16;
+    static constexpr unsigned char PUNT = 32;
+};
+
+
+//ways a simulated drive can end
+enum DriveResult {
+    TOUCHDOWN_DRIVE,
+    FIELD_GOAL_DRIVE,
+    PUNT_DRIVE,
+    //interceptions, fumbles, missed field goals, and failed fourth downs
+    TURNOVER_DRIVE,
+    SAFETY_DRIVE,
+    DRIVE_RESULTS
+};
+
+
+//empirical distribution of what happens next in every (down, toGo, yardLine) state
+//states with few plays use the plays of the same down and field position, then of the same down
+class DriveTransitions {
+public:
+    static constexpr int DOWNS = 4;
+    static constexpr int TO_GO_BUCKETS = 7;
+    static constexpr int YARD_LINE_BUCKETS = 10;
+    static constexpr int STATES = DOWNS * TO_GO_BUCKETS * YARD_LINE_BUCKETS;
+    //fewest plays a state needs before it stops borrowing from a coarser state
+    static constexpr int MIN_SAMPLES = 20;
+
+    //builds the distributions from every play with a down of 1-4, punts included
+    void build(const vector<const Play*>& plays);
+
+    bool empty() const;
+
+
+    //bytes held by its arrays, for the memory report
+    long memoryBytes() const;
+
+    //index of the state, -1 if it isn't a down of 1-4
+    static int stateOf(int down, int toGo, int yardLine);
+
+    //start and amount of the steps to sample from in a state
+    int sampleStart(int state) const;
+
+    int sampleCount(int state) const;
+
+    const DriveStep& step(int index) const;
+
+    static DriveStep stepOf(const Play& play);
+
+private:
+    static int toGoBucket(int toGo);
+
+    //steps of the fine states, then the down and field position states, then the down states
+    vector<DriveStep> steps;
+    //where the steps each fine state samples from start, and how many there are
+    vector<int> starts;
+    vector<int> counts;
+};
+
+
+//chances of every way a drive can end
+struct DriveOutlook {
+    long drives = 0;
+    long results[DRIVE_RESULTS] = {};
+    long plays = 0;
+    double seconds = 0;
+
+    void print() const;
+};
+
+
+class DriveSimulator {
+public:
+    //plays out drives from the situation on the worker pool, each task with its own random stream and counts
+    static DriveOutlook simulate(const DriveTransitions& transitions, const Play& currentSituation, long drives);
+
+private:
+    //longest drive simulated, anything longer counts as a turnover
+    static constexpr int MAX_DRIVE_PLAYS = 60;
+
+    //splitmix64, small and fast enough that every task can have its own
+    static uint64_t nextRandom(uint64_t& state);
+};
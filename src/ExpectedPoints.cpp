@@ -0,0 +1,366 @@
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iomanip>
+#include <map>
+
+
+#include "ExpectedPoints.h"
+#include "WorkerPool.h"
+
+
+using namespace std;
+
+
+//chance of one distinct step of a state
+struct StepOdds {
+    DriveStep step;
+    float probability;
+};
+
+
+int ExpectedPointsTable::stateOf(int timeBucket, int down, int toGo, int yardLine) {
+    toGo = min(max(toGo, 1), TO_GO_VALUES);
+    yardLine = min(max(yardLine, 1), YARD_LINES);
+    return ((timeBucket*DOWNS + down - 1)*TO_GO_VALUES + toGo - 1)*YARD_LINES + yardLine - 1;
+}
+
+
+int ExpectedPointsTable::fourthDownOf(int timeBucket, int toGo, int yardLine) {
+    toGo = min(max(toGo, 1), TO_GO_VALUES);
+    yardLine = min(max(yardLine, 1), YARD_LINES);
+    return (timeBucket*TO_GO_VALUES + toGo - 1)*YARD_LINES + yardLine - 1;
+}
+
+
+//same ranges as the time digit of the play code
+int ExpectedPointsTable::timeBucketOf(int minutes, int seconds) {
+    int timeInSeconds = minutes*60 + seconds;
+    if (timeInSeconds > 450) {
+        return 0;
+    }
+    if (timeInSeconds > 270) {
+        return 1;
+    }
+    if (timeInSeconds > 120) {
+        return 2;
+    }
+    return 3;
+}
+
+
+//value of a ball the opponent gets at the given yard line of ours
+float ExpectedPointsTable::opponentBall(const vector<float>& current, int timeBucket, int yardLine) const {
+    int opponentYardLine = min(max(100 - yardLine, 1), YARD_LINES);
+    return -current[stateOf(timeBucket, 1, min(10, 100 - opponentYardLine), opponentYardLine)];
+}
+
+
+//value of the state after a play with the given step was run from (timeBucket, down, toGo, yardLine)
+//scores end the expected points, so a touchdown is worth 7, a field goal 3, and a safety -2
+float ExpectedPointsTable::valueAfter(const vector<float>& current, int timeBucket, int down, int toGo, int yardLine,
+                                      const DriveStep& step) const {
+    if (step.flags & DriveStep::TURNOVER) {
+        return opponentBall(current, timeBucket, min(max(yardLine + step.yards, 1), YARD_LINES));
+    }
+    if (step.flags & DriveStep::FIELD_GOAL_ATTEMPT) {
+        return (step.flags & DriveStep::FIELD_GOAL_GOOD) ? 3.0f : opponentBall(current, timeBucket, yardLine);
+    }
+    if (step.flags & DriveStep::PUNT) {
+        return opponentBall(current, timeBucket, puntedTo(yardLine, step.yards));
+    }
+
+    int newYardLine = yardLine + step.yards;
+    if ((step.flags & DriveStep::TOUCHDOWN) || newYardLine >= 100) {
+        return 7.0f;
+    }
+    if (newYardLine <= 0) {
+        return -2.0f;
+    }
+    if ((step.flags & DriveStep::FIRST_DOWN) || step.yards >= toGo) {
+        return current[stateOf(timeBucket, 1, min(10, 100 - newYardLine), newYardLine)];
+    }
+    if (down == DOWNS) {
+        return opponentBall(current, timeBucket, newYardLine);
+    }
+    return current[stateOf(timeBucket, down + 1, toGo - step.yards, newYardLine)];
+}
+
+
+//a punt into the end zone is a touchback at the opponent's 20
+int ExpectedPointsTable::puntedTo(int yardLine, int netYards) {
+    return yardLine + netYards >= 100 ? 80 : min(max(yardLine + netYards, 1), YARD_LINES);
+}
+
+
+//solves the table by value iteration on the worker pool from the transitions of the plays
+//the transitions of each time bucket are reduced to the chance of every distinct step before iterating
+void ExpectedPointsTable::solve(const vector<const Play*>& plays, ostream& log) {
+    auto start = chrono::steady_clock::now();
+
+    vector<vector<const Play*>> bucketPlays(TIME_BUCKETS);
+    //field goal attempts and makes by 10 yard bucket
+    vector<int> attempts(10, 0);
+    vector<int> makes(10, 0);
+    //net yards of every punt by 10 yard bucket
+    vector<vector<int>> puntYards(10);
+    for (const Play* play : plays) {
+        bucketPlays[timeBucketOf(play->minutes, play->seconds)].push_back(play);
+        DriveStep step = DriveTransitions::stepOf(*play);
+        int yardLineBucket = min(max(play->yardLine, 0) / 10, 9);
+        if (step.flags & DriveStep::FIELD_GOAL_ATTEMPT) {
+            attempts[yardLineBucket]++;
+            makes[yardLineBucket] += (step.flags & DriveStep::FIELD_GOAL_GOOD) ? 1 : 0;
+        }
+        if (step.flags & DriveStep::PUNT) {
+            puntYards[yardLineBucket].push_back(step.yards);
+        }
+    }
+
+    auto oddsOf = [](const DriveTransitions& transitions, const vector<int>& states, bool skipKicks) {
+        //map<yards and flags, times seen>
+        map<int, int> seen;
+        int total = 0;
+        for (int state : states) {
+            int first = transitions.sampleStart(state);
+            for (int i = first; i < first + transitions.sampleCount(state); i++) {
+                const DriveStep& step = transitions.step(i);
+                if (skipKicks && (step.flags & (DriveStep::FIELD_GOAL_ATTEMPT | DriveStep::PUNT))) {
+                    continue;
+                }
+                seen[step.yards*256 + step.flags]++;
+                total++;
+            }
+        }
+        vector<StepOdds> odds;
+        for (const pair<const int, int>& entry : seen) {
+            DriveStep step;
+            step.yards = static_cast<short>(floor(entry.first / 256.0));
+            step.flags = static_cast<unsigned char>(entry.first - step.yards*256);
+            odds.push_back({step, static_cast<float>(entry.second) / static_cast<float>(total)});
+        }
+        return odds;
+    };
+
+    //stateOdds[timeBucket * DriveTransitions::STATES + state], goOdds the same but from third and fourth downs without kicks
+    vector<StepOdds> noOdds;
+    vector<vector<StepOdds>> stateOdds(TIME_BUCKETS * DriveTransitions::STATES);
+    vector<vector<StepOdds>> goOdds(TIME_BUCKETS * DriveTransitions::STATES);
+    for (int timeBucket = 0; timeBucket < TIME_BUCKETS; timeBucket++) {
+        DriveTransitions transitions;
+        transitions.build(bucketPlays[timeBucket]);
+        if (transitions.empty()) {
+            continue;
+        }
+        for (int state = 0; state < DriveTransitions::STATES; state++) {
+            stateOdds[timeBucket*DriveTransitions::STATES + state] = oddsOf(transitions, {state}, false);
+        }
+        for (int toGo = 1; toGo <= TO_GO_VALUES; toGo++) {
+            for (int yardLine = 1; yardLine <= YARD_LINES; yardLine++) {
+                int fourth = DriveTransitions::stateOf(4, toGo, yardLine);
+                int third = DriveTransitions::stateOf(3, toGo, yardLine);
+                if (goOdds[timeBucket*DriveTransitions::STATES + fourth].empty()) {
+                    goOdds[timeBucket*DriveTransitions::STATES + fourth] = oddsOf(transitions, {third, fourth}, true);
+                }
+            }
+        }
+    }
+
+    auto expectedValue = [&](const vector<float>& current, const vector<StepOdds>& odds, int timeBucket, int down, int toGo,
+                             int yardLine) {
+        float value = 0;
+        for (const StepOdds& stepOdds : odds) {
+            value += stepOdds.probability * valueAfter(current, timeBucket, down, toGo, yardLine, stepOdds.step);
+        }
+        return value;
+    };
+
+    //Jacobi iterations, every state reads the previous values so the states can be split between threads
+    const int MAX_ITERATIONS = 1000;
+    const float TOLERANCE = 1e-4f;
+    const int CHUNKS = 64;
+    vector<float> current(STATES, 0.0f);
+    vector<float> next(STATES, 0.0f);
+    vector<float> chunkDeltas(CHUNKS);
+    int iterations = 0;
+    float delta = 0;
+    for (; iterations < MAX_ITERATIONS; iterations++) {
+        WorkerPool::shared().parallelFor(CHUNKS, [&](int chunk) {
+            float chunkDelta = 0;
+            for (int state = chunk*STATES/CHUNKS; state < (chunk + 1)*STATES/CHUNKS; state++) {
+                int yardLine = state % YARD_LINES + 1;
+                int toGo = (state / YARD_LINES) % TO_GO_VALUES + 1;
+                int down = (state / (YARD_LINES*TO_GO_VALUES)) % DOWNS + 1;
+                int timeBucket = state / (YARD_LINES*TO_GO_VALUES*DOWNS);
+                const vector<StepOdds>& odds = stateOdds[timeBucket*DriveTransitions::STATES
+                                                         + DriveTransitions::stateOf(down, toGo, yardLine)];
+                next[state] = expectedValue(current, odds, timeBucket, down, toGo, yardLine);
+                chunkDelta = max(chunkDelta, fabs(next[state] - current[state]));
+            }
+            chunkDeltas[chunk] = chunkDelta;
+        });
+        current.swap(next);
+        delta = *max_element(chunkDeltas.begin(), chunkDeltas.end());
+        if (delta < TOLERANCE) {
+            iterations++;
+            break;
+        }
+    }
+    values = current;
+
+    //fourth down decisions from the solved values
+    int decisions = TIME_BUCKETS * TO_GO_VALUES * YARD_LINES;
+    goValues.assign(decisions, 0.0f);
+    fieldGoalValues.assign(decisions, 0.0f);
+    puntValues.assign(decisions, 0.0f);
+    for (int timeBucket = 0; timeBucket < TIME_BUCKETS; timeBucket++) {
+        for (int toGo = 1; toGo <= TO_GO_VALUES; toGo++) {
+            for (int yardLine = 1; yardLine <= YARD_LINES; yardLine++) {
+                int decision = fourthDownOf(timeBucket, toGo, yardLine);
+                goValues[decision] = expectedValue(values, goOdds[timeBucket*DriveTransitions::STATES
+                                                                  + DriveTransitions::stateOf(4, toGo, yardLine)],
+                                                   timeBucket, 4, toGo, yardLine);
+
+                int yardLineBucket = min(yardLine / 10, 9);
+                float makeChance = attempts[yardLineBucket] == 0 ? 0.0f
+                                   : static_cast<float>(makes[yardLineBucket]) / static_cast<float>(attempts[yardLineBucket]);
+                fieldGoalValues[decision] = makeChance*3.0f + (1 - makeChance)*opponentBall(values, timeBucket, yardLine);
+
+                //averaged over the punts from the same 10 yards, or a typical punt if there were none
+                const vector<int>& netYards = puntYards[yardLineBucket];
+                if (netYards.empty()) {
+                    puntValues[decision] = opponentBall(values, timeBucket, puntedTo(yardLine, NET_PUNT_YARDS));
+                    continue;
+                }
+                float puntValue = 0;
+                for (int yards : netYards) {
+                    puntValue += opponentBall(values, timeBucket, puntedTo(yardLine, yards));
+                }
+                puntValues[decision] = puntValue / static_cast<float>(netYards.size());
+            }
+        }
+    }
+
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    log << "Solved expected points for " << STATES << " states in " << iterations << " iterations (largest change ";
+    log << delta << ") in " << seconds << " seconds\n";
+}
+
+
+//header, then the values and the three decision arrays as raw floats
+bool ExpectedPointsTable::save(const string& filename) const {
+    if (values.empty()) {
+        return false;
+    }
+    string temporary = filename + ".tmp";
+    ofstream file(temporary, ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    const char magic[4] = {'G', 'G', 'E', 'P'};
+    int header[2] = {STATES, TIME_BUCKETS * TO_GO_VALUES * YARD_LINES};
+    file.write(magic, sizeof(magic));
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(values.data()), static_cast<streamsize>(values.size() * sizeof(float)));
+    for (const vector<float>* decision : {&goValues, &fieldGoalValues, &puntValues}) {
+        file.write(reinterpret_cast<const char*>(decision->data()), static_cast<streamsize>(decision->size() * sizeof(float)));
+    }
+    file.close();
+    if (!file || rename(temporary.c_str(), filename.c_str()) != 0) {
+        remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+
+bool ExpectedPointsTable::load(const string& filename) {
+    ifstream file(filename, ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    char magic[4];
+    int header[2];
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (!file || string(magic, 4) != "GGEP" || header[0] != STATES || header[1] != TIME_BUCKETS * TO_GO_VALUES * YARD_LINES) {
+        return false;
+    }
+
+    vector<float> loadedValues(STATES);
+    vector<vector<float>> loadedDecisions(3, vector<float>(header[1]));
+    file.read(reinterpret_cast<char*>(loadedValues.data()), static_cast<streamsize>(loadedValues.size() * sizeof(float)));
+    for (vector<float>& decision : loadedDecisions) {
+        file.read(reinterpret_cast<char*>(decision.data()), static_cast<streamsize>(decision.size() * sizeof(float)));
+    }
+    if (!file) {
+        return false;
+    }
+
+    values = std::move(loadedValues);
+    goValues = std::move(loadedDecisions[0]);
+    fieldGoalValues = std::move(loadedDecisions[1]);
+    puntValues = std::move(loadedDecisions[2]);
+    return true;
+}
+
+
+bool ExpectedPointsTable::empty() const {
+    return values.empty();
+}
+
+
+float ExpectedPointsTable::expectedPoints(const Play& currentSituation) const {
+    if (currentSituation.down < 1 || currentSituation.down > DOWNS) {
+        return 0.0f;
+    }
+    int timeBucket = timeBucketOf(currentSituation.minutes, currentSituation.seconds);
+    return values[stateOf(timeBucket, currentSituation.down, currentSituation.toGo, currentSituation.yardLine)];
+}
+
+
+FourthDownValues ExpectedPointsTable::fourthDown(const Play& currentSituation) const {
+    int decision = fourthDownOf(timeBucketOf(currentSituation.minutes, currentSituation.seconds),
+                                currentSituation.toGo, currentSituation.yardLine);
+    return {goValues[decision], fieldGoalValues[decision], puntValues[decision]};
+}
+
+
+//prints the expected points of the situation, and the best decision if it's fourth down
+void ExpectedPointsTable::printDecision(const Play& currentSituation) const {
+    if (empty() || currentSituation.down < 1 || currentSituation.down > DOWNS) {
+        return;
+    }
+
+    ios::fmtflags flags = cout.flags();
+    streamsize precision = cout.precision();
+    cout << fixed << setprecision(2);
+    cout << "EXPECTED POINTS OF THE NEXT SCORE: " << expectedPoints(currentSituation) << "\n";
+
+    if (currentSituation.down == DOWNS) {
+        FourthDownValues decision = fourthDown(currentSituation);
+        const char* best = "GO FOR IT";
+        if (decision.fieldGoal > decision.go && decision.fieldGoal >= decision.punt) {
+            best = "KICK A FIELD GOAL";
+        }
+        else if (decision.punt > decision.go && decision.punt > decision.fieldGoal) {
+            best = "PUNT";
+        }
+        cout << "FOURTH DOWN: go for it " << decision.go << ", field goal " << decision.fieldGoal;
+        cout << ", punt " << decision.punt << " -> " << best << "\n";
+    }
+    cout.flags(flags);
+    cout.precision(precision);
+    cout << endl;
+}
+
+
+long ExpectedPointsTable::memoryBytes() const {
+    return static_cast<long>((values.capacity() + goValues.capacity() + fieldGoalValues.capacity() + puntValues.capacity())
+                             * sizeof(float));
+}
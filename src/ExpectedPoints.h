@@ -0,0 +1,85 @@
+#pragma once
+#include <iostream>
+#include <string>
+#include <vector>
+
+
+#include "Play.h"
+#include "DriveSimulator.h"
+
+
+using namespace std;
+
+
+//expected points of going for it, kicking a field goal, and punting on fourth down
+struct FourthDownValues {
+    float go;
+    float fieldGoal;
+    float punt;
+};
+
+
+//expected points of the next score for every (time bucket, down, toGo, yardLine) state
+//solved offline by value iteration and stored as flat arrays, so a query is a single lookup
+class ExpectedPointsTable {
+public:
+    //the four time codes of the play code, from most time left to least
+    static constexpr int TIME_BUCKETS = 4;
+    static constexpr int DOWNS = 4;
+    //toGo of 20 or more share the last value
+    static constexpr int TO_GO_VALUES = 20;
+    //yard lines 1-99
+    static constexpr int YARD_LINES = 99;
+    static constexpr int STATES = TIME_BUCKETS * DOWNS * TO_GO_VALUES * YARD_LINES;
+
+    //net yards of a punt from a field position without any ingested punts, with a touchback at the 20
+    static constexpr int NET_PUNT_YARDS = 40;
+
+    //solves the table by value iteration on the worker pool from the transitions of the plays
+    //punts among the plays give the net yards a punt from each field position gains
+    //the iterations it took are written to log, which is buffered when the table is solved in the background
+    void solve(const vector<const Play*>& plays, ostream& log = cout);
+
+    //writes or reads the table as a compact binary file, returns false if it can't
+    //it is written next to the file and renamed over it, so a load never reads a half written table
+    bool save(const string& filename) const;
+
+    bool load(const string& filename);
+
+    bool empty() const;
+
+
+    //bytes held by its arrays, for the memory report
+    long memoryBytes() const;
+
+    //expected points of the situation, 0 for two point conversions
+    float expectedPoints(const Play& currentSituation) const;
+
+    FourthDownValues fourthDown(const Play& currentSituation) const;
+
+    //prints the expected points of the situation, and the best decision if it's fourth down
+    void printDecision(const Play& currentSituation) const;
+
+private:
+    //values[state], see stateOf
+    vector<float> values;
+    //fourth down decisions of every (time bucket, toGo, yardLine)
+    vector<float> goValues;
+    vector<float> fieldGoalValues;
+    vector<float> puntValues;
+
+    static int stateOf(int timeBucket, int down, int toGo, int yardLine);
+
+    static int fourthDownOf(int timeBucket, int toGo, int yardLine);
+
+    static int timeBucketOf(int minutes, int seconds);
+
+    //value of the state after a play with the given step was run from (timeBucket, down, toGo, yardLine)
+    float valueAfter(const vector<float>& current, int timeBucket, int down, int toGo, int yardLine, const DriveStep& step) const;
+
+    //yard line of ours the opponent gets the ball at after a punt netting the yards
+    static int puntedTo(int yardLine, int netYards);
+
+    //value of a ball the opponent gets at the given yard line of ours
+    float opponentBall(const vector<float>& current, int timeBucket, int yardLine) const;
+};
@@ -0,0 +1,64 @@
+#include <iostream>
+#include <string>
+#include <stdexcept>
+
+
+#include "AggregateExport.h"
+#include "SituationGrid.h"
+#include "PlayIngest.h"
+
+
+using namespace std;
+
+
+//writes the sharded aggregates the web dashboard downloads instead of the whole .csv
+int main(int argc, char* argv[]) {
+    string filename = "../files/pbp2013-2024.csv";
+    string outputDirectory = "../files/export";
+    //written instead of the shards if given, see SituationGrid::write
+    string gridFile;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--data" && i + 1 < argc) {
+            filename = argv[++i];
+        }
+        else if (arg == "--out" && i + 1 < argc) {
+            outputDirectory = argv[++i];
+        }
+        else if (arg == "--grid" && i + 1 < argc) {
+            gridFile = argv[++i];
+        }
+        else {
+            cerr << "Usage: " << argv[0] << " [--data <file.csv or directory of season .csv files>]";
+            cerr << " [--out <directory the shards are written to>]";
+            cerr << " [--grid <file the situation heatmap tensor is written to instead of the shards>]\n";
+            return 1;
+        }
+    }
+
+    //same rows and columns the console reads
+    IngestConfig ingestConfig = IngestConfig::defaultConfig();
+    vector<Play> plays;
+    IngestStats stats = PlayIngest::readFiles(PlayIngest::listDataFiles(filename), ingestConfig, plays);
+    stats.print(ingestConfig);
+    if (plays.empty()) {
+        cerr << "No plays were read from " << filename << endl;
+        return 1;
+    }
+
+    try {
+        if (!gridFile.empty()) {
+            SituationGrid grid;
+            grid.build(plays);
+            grid.print();
+            cout << "Wrote " << grid.write(gridFile) << " bytes to " << gridFile << endl;
+            return 0;
+        }
+        AggregateExport::write(plays, outputDirectory).print(outputDirectory);
+    }
+    catch (const exception& error) {
+        cerr << error.what() << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,266 @@
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+
+
+#include "GameSequences.h"
+#include "PackedSituations.h"
+#include "PlayDictionary.h"
+#include "WorkerPool.h"
+
+
+using namespace std;
+
+
+NextSnapCounts::NextSnapCounts() {
+    calls.assign(PREVIOUS_RESULTS, vector<int>(PlayDictionary::MAX_PLAY_TYPES * PlayDictionary::MAX_SUB_TYPES, 0));
+}
+
+
+void NextSnapCounts::merge(const NextSnapCounts& other) {
+    situations += other.situations;
+    for (int result = 0; result < PREVIOUS_RESULTS; result++) {
+        totals[result] += other.totals[result];
+        for (int call = 0; call < static_cast<int>(calls[result].size()); call++) {
+            calls[result][call] += other.calls[result][call];
+        }
+    }
+}
+
+
+//lists the three most common calls after each way the similar situations ended
+void NextSnapCounts::print() const {
+    if (situations == 0) {
+        return;
+    }
+    const string RESULT_NAMES[PREVIOUS_RESULTS] = {"a first down", "a gain short of the sticks", "no gain",
+                                                   "an incomplete pass", "a sack"};
+    cout << "NEXT SNAP OF THE SAME DRIVE AFTER " << situations << " SIMILAR SITUATIONS (in " << seconds << " seconds):\n";
+    for (int result = 0; result < PREVIOUS_RESULTS; result++) {
+        if (totals[result] == 0) {
+            continue;
+        }
+        vector<int> order;
+        for (int call = 0; call < static_cast<int>(calls[result].size()); call++) {
+            if (calls[result][call] > 0) {
+                order.push_back(call);
+            }
+        }
+        int shown = min(3, static_cast<int>(order.size()));
+        partial_sort(order.begin(), order.begin() + shown, order.end(), [&](int a, int b) {
+            return calls[result][a] > calls[result][b];
+        });
+
+        cout << "    After " << RESULT_NAMES[result] << " (" << totals[result] << "):";
+        for (int i = 0; i < shown; i++) {
+            int call = order[i];
+            const string& playType = PlayDictionary::decode(PlayDictionary::PLAY_TYPE, call / PlayDictionary::MAX_SUB_TYPES);
+            const string& subType = PlayDictionary::decode(PlayDictionary::SUB_TYPE, call % PlayDictionary::MAX_SUB_TYPES);
+            float percent = static_cast<float>(calls[result][call]) / static_cast<float>(totals[result]) * 100;
+            cout << (i == 0 ? " " : ", ") << playType << (subType.empty() ? "" : " " + subType) << " "
+                 << Helpers::formatPercentages(percent) << "%";
+        }
+        cout << endl;
+    }
+    cout << endl;
+}
+
+
+Snap GameSequences::snapOf(const Play& play) {
+    static const int FIELD_GOAL_CODE = PlayDictionary::encode(PlayDictionary::PLAY_TYPE, "FIELD GOAL");
+
+    Snap snap;
+    snap.situation = PackedSituations::pack(play);
+    snap.gameID = play.gameID;
+    snap.resultingYards = static_cast<short>(play.resultingYards);
+    snap.playTypeCode = static_cast<unsigned char>(play.playTypeCode);
+    snap.subTypeCode = static_cast<unsigned char>(play.isPass ? play.passTypeCode : play.isRush ? play.rushDirectionCode : 0);
+    snap.offenseCode = static_cast<unsigned char>(play.offenseCode);
+    snap.quarter = static_cast<unsigned char>(play.quarter);
+    snap.flags = 0;
+    if (play.resultIsFirstDown) snap.flags |= Snap::FIRST_DOWN;
+    if (play.isTouchdown) snap.flags |= Snap::TOUCHDOWN;
+    if (play.isIncomplete && play.isPass) snap.flags |= Snap::INCOMPLETE;
+    if (play.isSack) snap.flags |= Snap::SACK;
+    if (play.isInterception || play.isFumble) snap.flags |= Snap::TURNOVER;
+    if (play.playTypeCode == FIELD_GOAL_CODE || play.kickResult != NO_KICK) snap.flags |= Snap::KICK;
+    if (play.isPass) snap.flags |= Snap::PASS;
+    if (play.isRush) snap.flags |= Snap::RUSH;
+    return snap;
+}
+
+
+//the plays come in the order of the data structure they were built from, so plays that share a clock are put back
+//in the order of their rows, every game is read from a single file
+void GameSequences::build(const vector<const Play*>& plays) {
+    vector<const Play*> sorted(plays);
+    sort(sorted.begin(), sorted.end(), [](const Play* a, const Play* b) {
+        if (a->gameID != b->gameID) {
+            return a->gameID < b->gameID;
+        }
+        if (a->quarter != b->quarter) {
+            return a->quarter < b->quarter;
+        }
+        //the clock counts down, so more time left comes first
+        if (a->timeAsInt != b->timeAsInt) {
+            return a->timeAsInt > b->timeAsInt;
+        }
+        return a->fileRow < b->fileRow;
+    });
+
+    snaps.clear();
+    snaps.reserve(sorted.size());
+    gameStarts.clear();
+    driveStarts.clear();
+    gameOf.assign(sorted.size(), 0);
+    driveOf.assign(sorted.size(), 0);
+    for (int position = 0; position < static_cast<int>(sorted.size()); position++) {
+        snaps.push_back(snapOf(*sorted[position]));
+        const Snap& snap = snaps.back();
+
+        bool newGame = position == 0 || snap.gameID != snaps[position - 1].gameID;
+        bool newDrive = newGame;
+        if (!newGame) {
+            const Snap& previous = snaps[position - 1];
+            bool halftime = previous.quarter <= 2 && snap.quarter >= 3;
+            bool overtime = previous.quarter <= 4 && snap.quarter >= 5;
+            bool driveOver = previous.flags & (Snap::TOUCHDOWN | Snap::TURNOVER | Snap::KICK);
+            newDrive = snap.offenseCode != previous.offenseCode || halftime || overtime || driveOver;
+        }
+        if (newGame) {
+            gameStarts.push_back(position);
+        }
+        if (newDrive) {
+            driveStarts.push_back(position);
+        }
+        gameOf[position] = static_cast<int>(gameStarts.size()) - 1;
+        driveOf[position] = static_cast<int>(driveStarts.size()) - 1;
+    }
+    gameStarts.push_back(static_cast<int>(snaps.size()));
+    driveStarts.push_back(static_cast<int>(snaps.size()));
+}
+
+
+bool GameSequences::empty() const {
+    return snaps.empty();
+}
+
+
+int GameSequences::gameCount() const {
+    return gameStarts.empty() ? 0 : static_cast<int>(gameStarts.size()) - 1;
+}
+
+
+int GameSequences::driveCount() const {
+    return driveStarts.empty() ? 0 : static_cast<int>(driveStarts.size()) - 1;
+}
+
+
+const Snap& GameSequences::at(int position) const {
+    return snaps[position];
+}
+
+
+int GameSequences::nextInGame(int position) const {
+    return position + 1 < static_cast<int>(snaps.size()) && gameOf[position + 1] == gameOf[position] ? position + 1 : -1;
+}
+
+
+int GameSequences::previousInGame(int position) const {
+    return position > 0 && gameOf[position - 1] == gameOf[position] ? position - 1 : -1;
+}
+
+
+int GameSequences::nextInDrive(int position) const {
+    return position + 1 < static_cast<int>(snaps.size()) && driveOf[position + 1] == driveOf[position] ? position + 1 : -1;
+}
+
+
+int GameSequences::previousInDrive(int position) const {
+    return position > 0 && driveOf[position - 1] == driveOf[position] ? position - 1 : -1;
+}
+
+
+int GameSequences::gameStart(int game) const {
+    return gameStarts[game];
+}
+
+
+int GameSequences::gameEnd(int game) const {
+    return gameStarts[game + 1];
+}
+
+
+int GameSequences::driveStart(int drive) const {
+    return driveStarts[drive];
+}
+
+
+int GameSequences::driveEnd(int drive) const {
+    return driveStarts[drive + 1];
+}
+
+
+//checked in the order a snap can end, so a first down by a pass counts as a first down
+PreviousResult GameSequences::previousResult(const Snap& snap) {
+    if (snap.flags & Snap::FIRST_DOWN) {
+        return AFTER_FIRST_DOWN;
+    }
+    if (snap.flags & Snap::SACK) {
+        return AFTER_SACK;
+    }
+    if (snap.flags & Snap::INCOMPLETE) {
+        return AFTER_INCOMPLETE;
+    }
+    return snap.resultingYards > 0 ? AFTER_GAIN : AFTER_NO_GAIN;
+}
+
+
+//only passes and rushes count as calls, so a penalty or spike doesn't hide the next real call
+NextSnapCounts GameSequences::nextSnaps(const SituationBounds& bounds) const {
+    NextSnapCounts counts;
+    uint64_t lower;
+    uint64_t upper;
+    if (empty() || !PackedSituations::packBounds(bounds, lower, upper)) {
+        return counts;
+    }
+    auto start = chrono::steady_clock::now();
+
+    //a task per worker, each a contiguous range of games with its own counts
+    int games = gameCount();
+    int tasks = min(games, WorkerPool::shared().size());
+    vector<NextSnapCounts> taskCounts(tasks);
+    WorkerPool::shared().parallelFor(tasks, [&](int task) {
+        NextSnapCounts& local = taskCounts[task];
+        int firstGame = static_cast<int>(static_cast<long>(games) * task / tasks);
+        int lastGame = static_cast<int>(static_cast<long>(games) * (task + 1) / tasks);
+        for (int position = gameStart(firstGame); position < gameStart(lastGame); position++) {
+            if (!PackedSituations::matches(snaps[position].situation, lower, upper)) {
+                continue;
+            }
+            int next = nextInDrive(position);
+            while (next != -1 && !(snaps[next].flags & (Snap::PASS | Snap::RUSH))) {
+                next = nextInDrive(next);
+            }
+            if (next == -1) {
+                continue;
+            }
+            PreviousResult result = previousResult(snaps[position]);
+            local.situations++;
+            local.totals[result]++;
+            local.calls[result][snaps[next].playTypeCode * PlayDictionary::MAX_SUB_TYPES + snaps[next].subTypeCode]++;
+        }
+    });
+
+    for (const NextSnapCounts& local : taskCounts) {
+        counts.merge(local);
+    }
+    counts.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return counts;
+}
+
+
+long GameSequences::memoryBytes() const {
+    return static_cast<long>(snaps.capacity() * sizeof(Snap)
+                             + (gameStarts.capacity() + driveStarts.capacity() + gameOf.capacity() + driveOf.capacity()) * sizeof(int));
+}
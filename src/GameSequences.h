@@ -0,0 +1,117 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+
+
+#include "Play.h"
+#include "Helpers.h"
+
+
+using namespace std;
+
+
+//what the sequence queries need from one play, copied so the store outlives the data structure it was built from
+struct Snap {
+    //situation packed like PackedSituations, so it is checked against bounds the same way
+    uint64_t situation;
+    int gameID;
+    short resultingYards;
+    unsigned char playTypeCode;
+    //passType of a pass, rushDirection of a rush, 0 otherwise
+    unsigned char subTypeCode;
+    unsigned char offenseCode;
+    unsigned char quarter;
+    unsigned char flags;
+
+    static constexpr unsigned char FIRST_DOWN = 1;
+    static constexpr unsigned char TOUCHDOWN = 2;
+    static constexpr unsigned char INCOMPLETE = 4;
+    static constexpr unsigned char SACK = 8;
+    static constexpr unsigned char TURNOVER = 16;
+    static constexpr unsigned char KICK = 32;
+    static constexpr unsigned char PASS = 64;
+    static constexpr unsigned char RUSH = 128;
+};
+
+
+//how the play before a snap ended, the next snap calls are counted separately for each
+enum PreviousResult {
+    AFTER_FIRST_DOWN,
+    AFTER_GAIN,
+    AFTER_NO_GAIN,
+    AFTER_INCOMPLETE,
+    AFTER_SACK,
+    PREVIOUS_RESULTS
+};
+
+
+//counts of the calls made on the snap after similar situations, by how the similar situation ended
+struct NextSnapCounts {
+    long situations = 0;
+    //calls[result][playTypeCode * PlayDictionary::MAX_SUB_TYPES + subTypeCode]
+    vector<vector<int>> calls;
+    long totals[PREVIOUS_RESULTS] = {};
+    double seconds = 0;
+
+    NextSnapCounts();
+
+    void merge(const NextSnapCounts& other);
+
+    void print() const;
+};
+
+
+//every play sorted by game, quarter, clock and row, with offset arrays marking where each game and drive starts
+//the next and previous play of any play are the neighbouring positions, so walking a game or drive is O(1) per step
+//a drive ends when the offense changes, at halftime, or after a touchdown, turnover or kick
+class GameSequences {
+public:
+    //copies and sorts the plays, then finds the games and drives
+    void build(const vector<const Play*>& plays);
+
+    bool empty() const;
+
+    int gameCount() const;
+
+    int driveCount() const;
+
+    const Snap& at(int position) const;
+
+    //position of the next or previous play of the same game or drive, -1 if there is none
+    int nextInGame(int position) const;
+
+    int previousInGame(int position) const;
+
+    int nextInDrive(int position) const;
+
+    int previousInDrive(int position) const;
+
+    //positions from the first play of a game or drive up to but not including the first of the next one
+    int gameStart(int game) const;
+
+    int gameEnd(int game) const;
+
+    int driveStart(int drive) const;
+
+    int driveEnd(int drive) const;
+
+    //counts what was called on the next snap of the same drive after every play within the bounds
+    //games are split between the worker pool, each task with its own counts
+    NextSnapCounts nextSnaps(const SituationBounds& bounds) const;
+
+    //bytes held by the store and offset arrays, for the memory report
+    long memoryBytes() const;
+
+private:
+    vector<Snap> snaps;
+    //first position of every game and drive, with the amount of plays at the end
+    vector<int> gameStarts;
+    vector<int> driveStarts;
+    //game and drive of every position
+    vector<int> gameOf;
+    vector<int> driveOf;
+
+    static Snap snapOf(const Play& play);
+
+    static PreviousResult previousResult(const Snap& snap);
+};
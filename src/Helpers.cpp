@@ -2,10 +2,15 @@
 #include <string>
 #include <vector>
 #include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
 
 
 #include "Helpers.h"
 #include "PlayHashTable.h"
+#include "PlayDictionary.h"
 
 
 using namespace std;
@@ -29,6 +34,82 @@ bool Helpers::validateInput(const string& input, const string& inputType, int lo
         }
     }
 
+    if (inputType == "team") {
+        //any skips filtering by team, otherwise the team has to appear in the data
+        if (input != "any" && PlayDictionary::lookup(PlayDictionary::TEAM, input) == -1) {
+            cout << "Error: Team not found! Enter an abbreviation like KC or \"any\"\n";
+            return false;
+        }
+    }
+
+    if (inputType == "positive") {
+        //a number above 0 like 2 or 1.5
+        try {
+            size_t length;
+            if (stof(input, &length) <= 0 || length != input.length()) {
+                cout << "Error: Input has to be a number above 0!\n";
+                return false;
+            }
+        }
+        catch (exception& err) {
+            cout << "Error: Input not a number" << endl;
+            return false;
+        }
+    }
+
+    if (inputType == "seasons") {
+        //any skips filtering by season, otherwise a single season or a range like 2021-2024
+        if (input != "any") {
+            size_t dash = input.find('-');
+            string first = input.substr(0, dash);
+            string last = dash == string::npos ? first : input.substr(dash + 1);
+            bool isYear = first.length() == 4 && last.length() == 4;
+            for (char c : first + last) {
+                isYear = isYear && isdigit(static_cast<unsigned char>(c));
+            }
+            if (!isYear) {
+                cout << "Error: Seasons are invalid! Enter like this: 2023 or 2021-2024 or \"any\"\n";
+                return false;
+            }
+            if (stoi(first) > stoi(last)) {
+                cout << "Error: First season is after the last season!\n";
+                return false;
+            }
+        }
+    }
+
+    if (inputType == "weights") {
+        //default keeps the ratings from ingest, otherwise a weight for each outcome like 10,10,-100,-1000,5,1
+        if (input != "default") {
+            int weights = 0;
+            size_t start = 0;
+            while (start <= input.length()) {
+                size_t comma = input.find(',', start);
+                string weight = input.substr(start, comma == string::npos ? string::npos : comma - start);
+                size_t parsed = 0;
+                try {
+                    float value = stof(weight, &parsed);
+                    if (parsed != weight.length() || !isfinite(value) || fabs(value) > 100000.0f) {
+                        parsed = 0;
+                    }
+                }
+                catch (const exception&) {
+                    parsed = 0;
+                }
+                if (parsed == 0) {
+                    cout << "Error: Weights are invalid! Enter 6 numbers like this: 10,10,-100,-1000,5,1 or \"default\"\n";
+                    return false;
+                }
+                weights++;
+                start = comma == string::npos ? input.length() + 1 : comma + 1;
+            }
+            if (weights != 6) {
+                cout << "Error: Weights are invalid! Enter 6 numbers like this: 10,10,-100,-1000,5,1 or \"default\"\n";
+                return false;
+            }
+        }
+    }
+
     if (inputType == "time") {
         //checks if input of time is 5 characters long
         if (input.length() != 5) {
@@ -83,9 +164,10 @@ bool Helpers::booleanResult(int boolValue) {
 }
 
 
+//a negative base has no real power of 0.75, so lost yards are weighted by the power of their distance instead
 float Helpers::calculateWeight(int yards) {
     if (yards < 0) {
-        return 0.0f - static_cast<float>(pow(yards, 0.75));
+        return 0.0f - static_cast<float>(pow(-yards, 0.75));
     }
     else {
         return static_cast<float>(pow(yards, 0.75));
@@ -193,6 +275,223 @@ vector<int> Helpers::calculateYardLineBounds(int yardLine) {
 }
 
 
+//calculates the bounds of similar situations that every data structure filters with
+SituationBounds Helpers::calculateSituationBounds(const Play& currentSituation, const SeasonRange& seasons) {
+    SituationBounds bounds;
+    bounds.quarter = currentSituation.quarter;
+    bounds.down = currentSituation.down;
+
+    //handles if it is not determining a 2 point conversion
+    if (currentSituation.down != 0) {
+        //bounds for toGo have 1 yard leeway
+        vector<int> toGoBounds = calculateToGoBounds(currentSituation.toGo);
+        bounds.toGoLowerBound = toGoBounds[0];
+        bounds.toGoUpperBound = toGoBounds[1];
+
+        //bounds for yardLine have 5 yard leeway
+        vector<int> yardLineBounds = calculateYardLineBounds(currentSituation.yardLine);
+        bounds.yardLineLowerBound = yardLineBounds[0];
+        bounds.yardLineUpperBound = yardLineBounds[1];
+    }
+    //if it is determining a 2 point conversion
+    else {
+        bounds.toGoLowerBound = 0;
+        bounds.toGoUpperBound = 0;
+        bounds.yardLineLowerBound = 98;
+        bounds.yardLineUpperBound = 99;
+    }
+
+    //bounds for time always have 1:30 leeway
+    vector<int> timeBounds = calculateTimeBounds(currentSituation.minutes, currentSituation.seconds);
+    bounds.timeLowerBound = timeBounds[0];
+    bounds.timeUpperBound = timeBounds[1];
+
+    //teams are optional, an empty team matches every team
+    bounds.offenseCode = teamFilterCode(currentSituation.offense);
+    bounds.defenseCode = teamFilterCode(currentSituation.defense);
+
+    bounds.firstSeason = seasons.firstSeason;
+    bounds.lastSeason = seasons.lastSeason;
+
+    return bounds;
+}
+
+
+//bounds with the window of the given level, the default level gives the same bounds as calculateSituationBounds
+//two point conversions keep their toGo and yardLine, so only their time is widened
+SituationBounds Helpers::calculateWindowBounds(const Play& currentSituation, int level, const SeasonRange& seasons) {
+    SituationBounds bounds = calculateSituationBounds(currentSituation, seasons);
+    if (level == DEFAULT_WINDOW_LEVEL) {
+        return bounds;
+    }
+
+    if (currentSituation.down != 0) {
+        bounds.toGoLowerBound = currentSituation.toGo == 0 ? 0 : max(1, currentSituation.toGo - TO_GO_WINDOWS[level]);
+        bounds.toGoUpperBound = currentSituation.toGo == 0 ? 0 : min(99, currentSituation.toGo + TO_GO_WINDOWS[level]);
+        bounds.yardLineLowerBound = max(0, currentSituation.yardLine - YARD_LINE_WINDOWS[level]);
+        bounds.yardLineUpperBound = min(99, currentSituation.yardLine + YARD_LINE_WINDOWS[level]);
+    }
+
+    int seconds = currentSituation.minutes*60 + currentSituation.seconds;
+    int lowerSeconds = max(0, seconds - TIME_WINDOWS[level]);
+    int upperSeconds = min(900, seconds + TIME_WINDOWS[level]);
+    bounds.timeLowerBound = timeToInt(lowerSeconds / 60, lowerSeconds % 60);
+    bounds.timeUpperBound = timeToInt(upperSeconds / 60, upperSeconds % 60);
+
+    return bounds;
+}
+
+
+//dictionary code of a team to filter by, ANY_TEAM if empty
+int Helpers::teamFilterCode(const string& team) {
+    if (team.empty()) {
+        return SituationBounds::ANY_TEAM;
+    }
+
+    int code = PlayDictionary::lookup(PlayDictionary::TEAM, team);
+    if (code == -1) {
+        return SituationBounds::UNKNOWN_TEAM;
+    }
+    return code;
+}
+
+
+//converts a date written as YYYY-MM-DD into the number yyyymmdd, 0 if it isn't written that way
+int Helpers::dateToInt(const string& date) {
+    if (date.length() < 10 || date[4] != '-' || date[7] != '-') {
+        return 0;
+    }
+
+    int dateAsInt = 0;
+    for (int i = 0; i < 10; i++) {
+        if (i == 4 || i == 7) {
+            continue;
+        }
+        if (!isdigit(static_cast<unsigned char>(date[i]))) {
+            return 0;
+        }
+        dateAsInt = dateAsInt*10 + (date[i] - '0');
+    }
+    return dateAsInt;
+}
+
+
+//seasons start in the fall, so games before March are the playoffs of the previous year's season
+int Helpers::seasonFromDate(int dateAsInt) {
+    if (dateAsInt == 0) {
+        return 0;
+    }
+
+    int year = dateAsInt / 10000;
+    int month = (dateAsInt / 100) % 100;
+    if (month < 3) {
+        return year - 1;
+    }
+    return year;
+}
+
+
+//days since 1970-01-01 of a yyyymmdd date, from the days_from_civil algorithm by Howard Hinnant
+int Helpers::dateToDay(int dateAsInt) {
+    int year = dateAsInt / 10000;
+    int month = (dateAsInt / 100) % 100;
+    int day = dateAsInt % 100;
+
+    year -= month <= 2;
+    int era = (year >= 0 ? year : year - 399) / 400;
+    int yearOfEra = year - era*400;
+    int dayOfYear = (153*(month + (month > 2 ? -3 : 9)) + 2)/5 + day - 1;
+    int dayOfEra = yearOfEra*365 + yearOfEra/4 - yearOfEra/100 + dayOfYear;
+    return era*146097 + dayOfEra - 719468;
+}
+
+
+//reads "any", a single season like 2023, or a range like 2021-2024 (already validated)
+SeasonRange Helpers::parseSeasonRange(const string& input) {
+    if (input == "any") {
+        return SeasonRange::all();
+    }
+
+    size_t dash = input.find('-');
+    if (dash == string::npos) {
+        return {stoi(input), stoi(input)};
+    }
+    return {stoi(input.substr(0, dash)), stoi(input.substr(dash + 1))};
+}
+
+
+//weights of first down, touchdown, interception, fumble, two point conversion and yards, already checked by validateInput
+ScoringWeights Helpers::parseScoringWeights(const string& input) {
+    ScoringWeights weights;
+    if (input == "default") {
+        return weights;
+    }
+
+    float* fields[6] = {&weights.firstDown, &weights.touchdown, &weights.interception, &weights.fumble,
+                        &weights.twoPoint, &weights.yards};
+    size_t start = 0;
+    for (float* field : fields) {
+        size_t comma = input.find(',', start);
+        *field = stof(input.substr(start, comma == string::npos ? string::npos : comma - start));
+        start = comma + 1;
+    }
+    return weights;
+}
+
+
+bool ScoringWeights::isDefault() const {
+    ScoringWeights defaults;
+    return firstDown == defaults.firstDown && touchdown == defaults.touchdown && interception == defaults.interception
+           && fumble == defaults.fumble && twoPoint == defaults.twoPoint && yards == defaults.yards;
+}
+
+
+//a chain of fused multiply-adds over the outcome columns of the play, so a custom rating costs about as much as reading it
+int ScoringWeights::rating(const Play& play) const {
+    float score = yards * play.yardsWeight;
+    score = fmaf(firstDown, play.resultIsFirstDown ? 1.0f : 0.0f, score);
+    score = fmaf(touchdown, play.isTouchdown ? 1.0f : 0.0f, score);
+    score = fmaf(interception, play.isInterception ? 1.0f : 0.0f, score);
+    score = fmaf(fumble, play.isFumble ? 1.0f : 0.0f, score);
+    score = fmaf(twoPoint, play.isTwoPointConversionSuccessful ? 1.0f : 0.0f, score);
+    return static_cast<int>(lround(score * Helpers::RATING_SCALE));
+}
+
+
+SeasonRange SeasonRange::all() {
+    return {EARLIEST_SEASON, LATEST_SEASON};
+}
+
+
+bool SeasonRange::isAll() const {
+    return firstSeason <= EARLIEST_SEASON && lastSeason >= LATEST_SEASON;
+}
+
+
+//checks if quarter and down are same, toGo is within 1 yard inclusive
+//yardLine is within 5 yards inclusive, and time is within 1:30 inclusive
+//teams are compared by dictionary code when filtered
+bool SituationBounds::matches(const Play& play) const {
+    return play.quarter == quarter && play.down == down
+           && play.toGo >= toGoLowerBound && play.toGo <= toGoUpperBound
+           && play.yardLine >= yardLineLowerBound && play.yardLine <= yardLineUpperBound
+           && play.timeAsInt >= timeLowerBound && play.timeAsInt <= timeUpperBound
+           && (offenseCode == ANY_TEAM || play.offenseCode == offenseCode)
+           && (defenseCode == ANY_TEAM || play.defenseCode == defenseCode)
+           && play.season >= firstSeason && play.season <= lastSeason;
+}
+
+
+bool SituationBounds::hasTeamFilter() const {
+    return offenseCode != ANY_TEAM || defenseCode != ANY_TEAM;
+}
+
+
+bool SituationBounds::hasSeasonFilter() const {
+    return !SeasonRange{firstSeason, lastSeason}.isAll();
+}
+
+
 string Helpers::formatPercentages(float percentage) {
     string newPercentage = to_string(percentage);
     if (percentage >= 10) {
@@ -230,42 +529,184 @@ string Helpers::formatTime(int minute, int second) {
 }
 
 
-string Helpers::generatePlayCode(Play &play) {
+string Helpers::generatePlayCode(const Play& play) {
     string playCode;
 
     playCode += to_string(play.quarter);
     playCode += to_string(play.down);
+    playCode += toGoCode(play.toGo);
+    playCode += to_string(play.yardLine / 10);
+    playCode += timeCode(play.minutes*60 + play.seconds);
+
+    return playCode;
+}
+
 
-    int yds2go = play.toGo;
+//digit of the play code for yards to go, empty if toGo doesn't fall in a range
+string Helpers::toGoCode(int yds2go) {
     if(yds2go>=1 && yds2go<=3)
-        playCode += "0";
+        return "0";
 
     else if(yds2go>=4 && yds2go<=7)
-        playCode += "1";
+        return "1";
 
     else if(yds2go>=8 && yds2go<=13)
-        playCode += "2";
+        return "2";
 
     else if(yds2go>=14 && yds2go<=20)
-        playCode += "3";
+        return "3";
 
     else if(yds2go>=21)
-        playCode += "4";
+        return "4";
+
+    return "";
+}
 
-    playCode += to_string(play.yardLine / 10);
 
-    int timeInSeconds = play.minutes*60 + play.seconds;
+//digit of the play code for time left in the quarter, empty if time doesn't fall in a range
+string Helpers::timeCode(int timeInSeconds) {
     if(timeInSeconds<=900 && timeInSeconds>=451)
-        playCode += "0";
+        return "0";
 
     else if(timeInSeconds<=450 && timeInSeconds>=271)
-        playCode += "1";
+        return "1";
 
     else if(timeInSeconds<=270 && timeInSeconds>=121)
-        playCode += "2";
+        return "2";
 
     else if(timeInSeconds<=120)
-        playCode += "3";
+        return "3";
 
-    return playCode;
+    return "";
+}
+
+
+//converts a time bound made by timeToInt into seconds, rounding inward to the nearest real time
+int Helpers::timeBoundToSeconds(int timeBound, bool isUpperBound) {
+    if (timeBound < 0) {
+        return isUpperBound ? -1 : 0;
+    }
+
+    int minute = timeBound / 100;
+    int second = timeBound % 100;
+    if (second >= 60) {
+        return isUpperBound ? minute*60 + 59 : (minute+1)*60;
+    }
+    return minute*60 + second;
+}
+
+
+//lists the code of every hash bucket that can hold a play within the bounds
+//toGo, yardLine, and time leeways can cross into neighboring buckets, so one code is not enough
+vector<string> Helpers::generatePlayCodes(const SituationBounds& bounds) {
+    vector<string> toGoCodes;
+    for (int toGo = bounds.toGoLowerBound; toGo <= bounds.toGoUpperBound; toGo++) {
+        string code = toGoCode(toGo);
+        if (find(toGoCodes.begin(), toGoCodes.end(), code) == toGoCodes.end()) {
+            toGoCodes.push_back(code);
+        }
+    }
+
+    int lowerSeconds = timeBoundToSeconds(bounds.timeLowerBound, false);
+    int upperSeconds = timeBoundToSeconds(bounds.timeUpperBound, true);
+    vector<string> timeCodes;
+    //time codes only change at 120, 270, 450, and 900 seconds so only those boundaries need to be visited
+    const vector<int> TIME_CODE_STARTS = {0, 121, 271, 451, 901};
+    for (int start : TIME_CODE_STARTS) {
+        int seconds = max(start, lowerSeconds);
+        if (seconds > upperSeconds) {
+            break;
+        }
+        string code = timeCode(seconds);
+        if (find(timeCodes.begin(), timeCodes.end(), code) == timeCodes.end()) {
+            timeCodes.push_back(code);
+        }
+    }
+
+    vector<string> playCodes;
+    string prefix = to_string(bounds.quarter) + to_string(bounds.down);
+    for (const string& toGo : toGoCodes) {
+        for (int yardLine = bounds.yardLineLowerBound / 10; yardLine <= bounds.yardLineUpperBound / 10; yardLine++) {
+            for (const string& time : timeCodes) {
+                playCodes.push_back(prefix + toGo + to_string(yardLine) + time);
+            }
+        }
+    }
+    return playCodes;
+}
+
+
+//combines the weights of a play into a single fixed-point integer so it only has to be computed once at ingest
+int Helpers::calculateRating(const Play& play) {
+    //first downs get 10 points, yards range from -99^0.75 to 99^0.75 points, touchdowns get 10, interceptions get -100,
+    //two pt conversions get 5, fumbles get -1000
+    float playRating = play.firstDownWeight + play.yardsWeight + play.touchdownWeight + play.interceptionWeight
+                       + play.twoPointWeight + play.fumbleWeight;
+
+    return static_cast<int>(lround(playRating * RATING_SCALE));
+}
+
+
+//sorts plays from highest to lowest rating with an LSD radix sort over the rating key
+//a descending array already satisfies the max heap property, so no heap operations are needed
+void Helpers::radixSortByRating(vector<Play>& plays) {
+    size_t size = plays.size();
+    if (size < 2) {
+        return;
+    }
+
+    //flips the sign bit so negative ratings order correctly as unsigned, then inverts for descending order
+    vector<uint32_t> keys(size);
+    for (size_t i = 0; i < size; i++) {
+        keys[i] = ~(static_cast<uint32_t>(plays[i].rating) ^ 0x80000000u);
+    }
+
+    vector<uint32_t> order(size);
+    vector<uint32_t> buffer(size);
+    for (size_t i = 0; i < size; i++) {
+        order[i] = static_cast<uint32_t>(i);
+    }
+
+    //4 passes of 8 bits each, skipping any pass where every key shares the same byte
+    for (int shift = 0; shift < 32; shift += 8) {
+        size_t counts[257] = {};
+        for (size_t i = 0; i < size; i++) {
+            counts[((keys[order[i]] >> shift) & 0xFF) + 1]++;
+        }
+        if (counts[((keys[order[0]] >> shift) & 0xFF) + 1] == size) {
+            continue;
+        }
+        for (int digit = 0; digit < 256; digit++) {
+            counts[digit + 1] += counts[digit];
+        }
+        for (size_t i = 0; i < size; i++) {
+            buffer[counts[(keys[order[i]] >> shift) & 0xFF]++] = order[i];
+        }
+        order.swap(buffer);
+    }
+
+    //moves the plays into their sorted positions once
+    vector<Play> sortedPlays;
+    sortedPlays.reserve(size);
+    for (size_t i = 0; i < size; i++) {
+        sortedPlays.push_back(std::move(plays[order[i]]));
+    }
+    plays = std::move(sortedPlays);
+}
+
+
+//returns the position of the highest rating in a dense array of ratings, or -1 if it is empty
+//plays[i] is the play rated ratings[i], equal ratings go to the play read first so both data structures agree
+int Helpers::bestRatedIndex(const vector<int>& ratings, const vector<const Play*>& plays) {
+    int bestIndex = -1;
+    int bestRating = 0;
+
+    for (int i = 0; i < static_cast<int>(ratings.size()); i++) {
+        if (bestIndex == -1 || ratings[i] > bestRating
+            || (ratings[i] == bestRating && plays[i]->ingestedBefore(*plays[bestIndex]))) {
+            bestIndex = i;
+            bestRating = ratings[i];
+        }
+    }
+    return bestIndex;
 }
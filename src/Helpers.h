@@ -9,8 +9,103 @@
 using namespace std;
 
 
+//inclusive range of seasons a query looks at
+//a season is named after the year it starts in, so playoff games in January and February belong to the year before
+struct SeasonRange {
+    int firstSeason;
+    int lastSeason;
+
+    static constexpr int EARLIEST_SEASON = 0;
+    static constexpr int LATEST_SEASON = 9999;
+
+    //every season in the data
+    static SeasonRange all();
+
+    bool isAll() const;
+};
+
+
+//inclusive bounds of the similar situations for a given current situation
+struct SituationBounds {
+    int quarter;
+    int down;
+    int toGoLowerBound;
+    int toGoUpperBound;
+    int yardLineLowerBound;
+    int yardLineUpperBound;
+    int timeLowerBound;
+    int timeUpperBound;
+    //dictionary codes of the teams to filter by, ANY_TEAM if not filtered
+    int offenseCode;
+    int defenseCode;
+    //seasons to look at, every season if not filtered
+    int firstSeason;
+    int lastSeason;
+
+    static constexpr int ANY_TEAM = -1;
+    //for teams that never appear in the data, so nothing matches
+    static constexpr int UNKNOWN_TEAM = -2;
+
+    bool matches(const Play& play) const;
+
+    bool hasTeamFilter() const;
+
+    bool hasSeasonFilter() const;
+};
+
+
+//optional ways a query can be run, set from the command line and prompts
+//weights of the outcomes the best play is rated by, the defaults give the rating computed at ingest (see Helpers::calculateRating)
+//a team that fears turnovers less can lower the interception and fumble weights without rebuilding either data structure
+struct ScoringWeights {
+    float firstDown = 10.0f;
+    float touchdown = 10.0f;
+    float interception = -100.0f;
+    float fumble = -1000.0f;
+    float twoPoint = 5.0f;
+    //multiplies the signed yards^0.75 of a play
+    float yards = 1.0f;
+
+    bool isDefault() const;
+
+    //fixed-point rating of a play under these weights, only computed for plays within the bounds
+    int rating(const Play& play) const;
+};
+
+
+struct QueryOptions {
+    SeasonRange seasons = SeasonRange::all();
+    //weights every similar situation by 2^(-age/halfLife) when above 0, otherwise every season counts equally
+    float halfLifeSeasons = 0.0f;
+    //when above 0 and no situation is within the bounds, the K most similar situations are used instead
+    int nearestNeighbors = 0;
+    //when above 0 the window is widened or narrowed until it holds about this many plays
+    int targetSample = 0;
+    //prints a 95% interval with every likelihood, bootstrapped if it fits in the latency budget
+    bool confidenceIntervals = false;
+    int latencyBudgetMs = 250;
+    //prints how many rows and bytes the scan of each query read
+    bool showStats = false;
+    //when not empty, only plays whose descriptions use every one of these words are similar situations
+    //only the heap filters by them, and only once its text index is built
+    string keywords;
+    //the best play and the order of the top historical plays, the ratings from ingest are used while they are the defaults
+    ScoringWeights weights;
+};
+
+
 class Helpers {
 public:
+    //fixed-point scale used for play ratings (2 decimal places)
+    static constexpr int RATING_SCALE = 100;
+
+    //windows from narrowest to widest, level 1 is the usual +/-1 yard to go, +/-5 yards, and +/-1:30
+    static constexpr int WINDOW_LEVELS = 5;
+    static constexpr int DEFAULT_WINDOW_LEVEL = 1;
+    static constexpr int TO_GO_WINDOWS[WINDOW_LEVELS] = {0, 1, 2, 3, 5};
+    static constexpr int YARD_LINE_WINDOWS[WINDOW_LEVELS] = {2, 5, 8, 12, 20};
+    static constexpr int TIME_WINDOWS[WINDOW_LEVELS] = {30, 90, 180, 300, 900};
+
     static bool validateInput(const string& input, const string& inputType, int lowerBound, int upperBound);
 
     static bool booleanResult(int boolValue);
@@ -25,9 +120,40 @@ public:
 
     static vector<int> calculateYardLineBounds(int yardLine);
 
+    static SituationBounds calculateSituationBounds(const Play& currentSituation,
+                                                    const SeasonRange& seasons = SeasonRange::all());
+
+    static SituationBounds calculateWindowBounds(const Play& currentSituation, int level, const SeasonRange& seasons);
+
+    static int teamFilterCode(const string& team);
+
+    static int dateToInt(const string& date);
+
+    static int seasonFromDate(int dateAsInt);
+
+    static int dateToDay(int dateAsInt);
+
+    static SeasonRange parseSeasonRange(const string& input);
+
+    static ScoringWeights parseScoringWeights(const string& input);
+
     static string formatPercentages(float percentage);
 
     static string formatTime(int minute, int second);
 
-    static string generatePlayCode(Play& play);
+    static string generatePlayCode(const Play& play);
+
+    static string toGoCode(int yds2go);
+
+    static string timeCode(int timeInSeconds);
+
+    static int timeBoundToSeconds(int timeBound, bool isUpperBound);
+
+    static vector<string> generatePlayCodes(const SituationBounds& bounds);
+
+    static int calculateRating(const Play& play);
+
+    static void radixSortByRating(vector<Play>& plays);
+
+    static int bestRatedIndex(const vector<int>& ratings, const vector<const Play*>& plays);
 };
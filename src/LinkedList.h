@@ -6,7 +6,11 @@
 #define PROJECT3_LINKEDLIST_H
 
 
+#include <vector>
+
+
 #include "Play.h"
+#include "BucketSummary.h"
 
 class LinkedList {
 private:
@@ -21,6 +25,9 @@ public:
     Play* head = nullptr;
 
     Play* tail = nullptr;
+
+    //one summary per play code in this bucket, see PlayHashTable::summarizeBuckets
+    vector<BucketSummary> summaries;
 };
 
 #endif //PROJECT3_LINKEDLIST_H
@@ -0,0 +1,102 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+
+
+#include "MemoryAccounting.h"
+
+
+using namespace std;
+
+
+void MemoryReport::add(const string& name, long bytes) {
+    parts.emplace_back(name, bytes);
+}
+
+
+long MemoryReport::total() const {
+    long bytes = 0;
+    for (const pair<string, long>& part : parts) {
+        bytes += part.second;
+    }
+    return bytes;
+}
+
+
+void MemoryReport::print() const {
+    cout << title << ": " << MemoryAccounting::formatBytes(total()) << endl;
+    for (const pair<string, long>& part : parts) {
+        cout << "    " << part.first << ": " << MemoryAccounting::formatBytes(part.second) << endl;
+    }
+}
+
+
+//a string in its small string buffer points into itself
+long MemoryAccounting::stringBytes(const string& value) {
+    const char* data = value.data();
+    const char* self = reinterpret_cast<const char*>(&value);
+    if (data >= self && data < self + sizeof(string)) {
+        return 0;
+    }
+    return static_cast<long>(value.capacity() + 1);
+}
+
+
+long MemoryAccounting::playBytes(const Play& play) {
+    return static_cast<long>(sizeof(Play)) + stringBytes(play.gameDate) + stringBytes(play.offense)
+           + stringBytes(play.defense) + stringBytes(play.description) + stringBytes(play.formation)
+           + stringBytes(play.playType) + stringBytes(play.passType) + stringBytes(play.rushDirection);
+}
+
+
+long MemoryAccounting::residentBytes() {
+    return statusBytes("VmRSS:");
+}
+
+
+long MemoryAccounting::peakResidentBytes() {
+    return statusBytes("VmHWM:");
+}
+
+
+//writing 5 to clear_refs resets the peak resident set on Linux
+bool MemoryAccounting::resetPeak() {
+    ofstream clearRefs("/proc/self/clear_refs");
+    if (!clearRefs.is_open()) {
+        return false;
+    }
+    clearRefs << "5";
+    clearRefs.flush();
+    return clearRefs.good();
+}
+
+
+long MemoryAccounting::evictColdFields(Play& play) {
+    long freed = stringBytes(play.description);
+    string().swap(play.description);
+    return freed;
+}
+
+
+string MemoryAccounting::formatBytes(long bytes) {
+    if (bytes < 0) {
+        return "unknown";
+    }
+    ostringstream formatted;
+    formatted << fixed << setprecision(1) << static_cast<double>(bytes) / (1024.0 * 1024.0) << " MB";
+    return formatted.str();
+}
+
+
+//values of /proc/self/status are in kB, like "VmRSS:    123456 kB"
+long MemoryAccounting::statusBytes(const string& field) {
+    ifstream status("/proc/self/status");
+    string line;
+    while (getline(status, line)) {
+        if (line.compare(0, field.size(), field) == 0) {
+            return stol(line.substr(field.size())) * 1024;
+        }
+    }
+    return -1;
+}
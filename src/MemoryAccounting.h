@@ -0,0 +1,52 @@
+#pragma once
+#include <string>
+#include <vector>
+
+
+#include "Play.h"
+
+
+using namespace std;
+
+
+//bytes held by each part of a data structure, printed with --stats
+struct MemoryReport {
+    string title;
+    vector<pair<string, long>> parts;
+
+    void add(const string& name, long bytes);
+
+    long total() const;
+
+    void print() const;
+};
+
+
+//size estimates for the data structures and the resident set of the process
+class MemoryAccounting {
+public:
+    //bytes a string holds outside of itself, 0 if it fits in its small string buffer
+    static long stringBytes(const string& value);
+
+    //bytes of a play including the text of its strings
+    static long playBytes(const Play& play);
+
+    //resident set of the process from /proc/self/status, -1 where it can't be read
+    static long residentBytes();
+
+    //largest resident set since the process started or since resetPeak
+    static long peakResidentBytes();
+
+    //starts measuring the peak again from the current resident set, false if the kernel doesn't allow it
+    static bool resetPeak();
+
+    //drops the description of a play, which only gets printed for the best play
+    //what queries need from it was already parsed into columns at ingest, returns the bytes freed
+    static long evictColdFields(Play& play);
+
+    //like 12.3 MB
+    static string formatBytes(long bytes);
+
+private:
+    static long statusBytes(const string& field);
+};
@@ -0,0 +1,175 @@
+#include <algorithm>
+
+
+#include "PackedSituations.h"
+#include "PlayDictionary.h"
+
+
+using namespace std;
+
+
+namespace {
+    //offset and width of every field that is compared against the bounds
+    enum PackedField {QUARTER_FIELD, DOWN_FIELD, TO_GO_FIELD, YARD_LINE_FIELD, TIME_FIELD, SEASON_FIELD, OFFENSE_FIELD,
+                      DEFENSE_FIELD, PACKED_FIELDS};
+    const int OFFSETS[PACKED_FIELDS] = {0, 4, 8, 16, 24, 35, 42, 50};
+    const int WIDTHS[PACKED_FIELDS] = {3, 3, 7, 7, 10, 6, 7, 7};
+    const int OUTCOME_OFFSET = 58;
+    const int PASS_BIT = 62;
+    const int RUSH_BIT = 63;
+
+    uint64_t guardBits() {
+        uint64_t guards = 0;
+        for (int field = 0; field < PACKED_FIELDS; field++) {
+            guards |= uint64_t(1) << (OFFSETS[field] + WIDTHS[field]);
+        }
+        return guards;
+    }
+
+    uint64_t fieldBits() {
+        uint64_t fields = 0;
+        for (int field = 0; field < PACKED_FIELDS; field++) {
+            fields |= ((uint64_t(1) << WIDTHS[field]) - 1) << OFFSETS[field];
+        }
+        return fields;
+    }
+
+    const uint64_t GUARDS = guardBits();
+    const uint64_t FIELDS = fieldBits();
+
+    //keeps a value inside its field so it can't spill into the next one
+    uint64_t put(PackedField field, int value) {
+        int highest = (1 << WIDTHS[field]) - 1;
+        return static_cast<uint64_t>(min(max(value, 0), highest)) << OFFSETS[field];
+    }
+}
+
+
+uint64_t PackedSituations::pack(const Play& play) {
+    uint64_t word = put(QUARTER_FIELD, play.quarter) | put(DOWN_FIELD, play.down) | put(TO_GO_FIELD, play.toGo)
+                    | put(YARD_LINE_FIELD, play.yardLine) | put(TIME_FIELD, play.minutes*60 + play.seconds)
+                    | put(SEASON_FIELD, play.season - SEASON_BASE) | put(OFFENSE_FIELD, play.offenseCode)
+                    | put(DEFENSE_FIELD, play.defenseCode);
+    word |= static_cast<uint64_t>(play.outcomes & 0xF) << OUTCOME_OFFSET;
+    word |= static_cast<uint64_t>(play.isPass ? 1 : 0) << PASS_BIT;
+    word |= static_cast<uint64_t>(play.isRush ? 1 : 0) << RUSH_BIT;
+    return word;
+}
+
+
+void PackedSituations::build(const vector<Play>& plays) {
+    words.resize(plays.size());
+    for (int i = 0; i < static_cast<int>(plays.size()); i++) {
+        words[i] = pack(plays[i]);
+    }
+}
+
+
+//packed lower and upper bounds, false if nothing can match (like a team that isn't in the data)
+bool PackedSituations::packBounds(const SituationBounds& bounds, uint64_t& lower, uint64_t& upper) {
+    if (bounds.offenseCode == SituationBounds::UNKNOWN_TEAM || bounds.defenseCode == SituationBounds::UNKNOWN_TEAM) {
+        return false;
+    }
+
+    //times are packed as seconds, so the timeToInt bounds are rounded inward to real times
+    int lowerSeconds = Helpers::timeBoundToSeconds(bounds.timeLowerBound, false);
+    int upperSeconds = Helpers::timeBoundToSeconds(bounds.timeUpperBound, true);
+    int anyTeamHighest = (1 << WIDTHS[OFFENSE_FIELD]) - 1;
+    int lowerOffense = bounds.offenseCode == SituationBounds::ANY_TEAM ? 0 : bounds.offenseCode;
+    int upperOffense = bounds.offenseCode == SituationBounds::ANY_TEAM ? anyTeamHighest : bounds.offenseCode;
+    int lowerDefense = bounds.defenseCode == SituationBounds::ANY_TEAM ? 0 : bounds.defenseCode;
+    int upperDefense = bounds.defenseCode == SituationBounds::ANY_TEAM ? anyTeamHighest : bounds.defenseCode;
+
+    //an empty range can't be packed, since clamping would turn it into a range that matches something
+    if (bounds.toGoLowerBound > bounds.toGoUpperBound || bounds.yardLineLowerBound > bounds.yardLineUpperBound
+        || lowerSeconds > upperSeconds || bounds.firstSeason > bounds.lastSeason) {
+        return false;
+    }
+
+    lower = put(QUARTER_FIELD, bounds.quarter) | put(DOWN_FIELD, bounds.down) | put(TO_GO_FIELD, bounds.toGoLowerBound)
+            | put(YARD_LINE_FIELD, bounds.yardLineLowerBound) | put(TIME_FIELD, lowerSeconds)
+            | put(SEASON_FIELD, bounds.firstSeason - SEASON_BASE) | put(OFFENSE_FIELD, lowerOffense)
+            | put(DEFENSE_FIELD, lowerDefense);
+    upper = put(QUARTER_FIELD, bounds.quarter) | put(DOWN_FIELD, bounds.down) | put(TO_GO_FIELD, bounds.toGoUpperBound)
+            | put(YARD_LINE_FIELD, bounds.yardLineUpperBound) | put(TIME_FIELD, upperSeconds)
+            | put(SEASON_FIELD, bounds.lastSeason - SEASON_BASE) | put(OFFENSE_FIELD, upperOffense)
+            | put(DEFENSE_FIELD, upperDefense);
+    return true;
+}
+
+
+//a field's guard bit survives the subtraction only if nothing had to be borrowed from it
+//...so (word | guards) - lower keeps every guard if each field is at least its lower bound, and the same for upper - word
+bool PackedSituations::matches(uint64_t word, uint64_t lower, uint64_t upper) {
+    uint64_t fields = word & FIELDS;
+    uint64_t atLeastLower = ((fields | GUARDS) - lower) & GUARDS;
+    uint64_t atMostUpper = ((upper | GUARDS) - fields) & GUARDS;
+    return (atLeastLower & atMostUpper) == GUARDS;
+}
+
+
+//the fields are read from the most significant of the key down, and seconds take 10 bits, yardLine and toGo 7
+uint32_t PackedSituations::situationKey(uint64_t word) {
+    auto get = [word](PackedField field) {
+        return static_cast<uint32_t>((word >> OFFSETS[field]) & ((uint64_t(1) << WIDTHS[field]) - 1));
+    };
+    return ((((get(QUARTER_FIELD) << WIDTHS[DOWN_FIELD] | get(DOWN_FIELD)) << WIDTHS[TO_GO_FIELD] | get(TO_GO_FIELD))
+             << WIDTHS[YARD_LINE_FIELD] | get(YARD_LINE_FIELD)) << WIDTHS[TIME_FIELD]) | get(TIME_FIELD);
+}
+
+
+//adds 0 or 1 instead of branching on every outcome
+void PackedSituations::addOutcomes(PackedTotals& totals, uint64_t word, uint64_t matched) {
+    uint64_t outcomes = (word >> OUTCOME_OFFSET) & 0xF;
+    totals.situations += static_cast<long>(matched);
+    totals.firstDowns += static_cast<long>(matched & outcomes);
+    totals.touchdowns += static_cast<long>(matched & (outcomes >> 1));
+    totals.fieldGoals += static_cast<long>(matched & (outcomes >> 2));
+    totals.twoPoints += static_cast<long>(matched & (outcomes >> 3));
+}
+
+
+vector<int> PackedSituations::matchingRows(const SituationBounds& bounds) const {
+    vector<int> rows;
+    uint64_t lower;
+    uint64_t upper;
+    if (!packBounds(bounds, lower, upper)) {
+        return rows;
+    }
+    for (int i = 0; i < static_cast<int>(words.size()); i++) {
+        if (matches(words[i], lower, upper)) {
+            rows.push_back(i);
+        }
+    }
+    return rows;
+}
+
+
+//counts the plays within the bounds and their outcomes without looking at the plays
+PackedTotals PackedSituations::aggregate(const SituationBounds& bounds) const {
+    PackedTotals totals;
+    uint64_t lower;
+    uint64_t upper;
+    if (!packBounds(bounds, lower, upper)) {
+        return totals;
+    }
+    for (uint64_t word : words) {
+        addOutcomes(totals, word, matches(word, lower, upper) ? 1 : 0);
+    }
+    return totals;
+}
+
+
+const vector<uint64_t>& PackedSituations::getWords() const {
+    return words;
+}
+
+
+int PackedSituations::bytesPerPlay() const {
+    return static_cast<int>(sizeof(uint64_t));
+}
+
+
+long PackedSituations::memoryBytes() const {
+    return static_cast<long>(words.capacity() * sizeof(uint64_t));
+}
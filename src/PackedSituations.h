@@ -0,0 +1,69 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+
+
+#include "Play.h"
+#include "Helpers.h"
+
+
+using namespace std;
+
+
+//outcomes of the plays within some bounds, added up straight from the packed words
+struct PackedTotals {
+    long situations = 0;
+    long firstDowns = 0;
+    long touchdowns = 0;
+    long fieldGoals = 0;
+    long twoPoints = 0;
+};
+
+
+//the situation columns of every play bit-packed into one 64-bit word, in the same order as the plays
+//every field has a guard bit above it, so a whole word is compared against the bounds with two subtractions
+//   bits  0-2   quarter        bits 24-33 seconds left   bits 58-61 PlayOutcome flags
+//   bits  4-6   down           bits 35-40 season - 1970  bit  62    isPass
+//   bits  8-14  toGo           bits 42-48 offense code   bit  63    isRush
+//   bits 16-22  yardLine       bits 50-56 defense code
+class PackedSituations {
+public:
+    void build(const vector<Play>& plays);
+
+    //the word of a single play
+    static uint64_t pack(const Play& play);
+
+    //packed lower and upper bounds, false if nothing can match (like a team that isn't in the data)
+    static bool packBounds(const SituationBounds& bounds, uint64_t& lower, uint64_t& upper);
+
+    //checks every field of a word against the packed bounds at once
+    static bool matches(uint64_t word, uint64_t lower, uint64_t upper);
+
+    //quarter, down, toGo, yardLine and seconds of a word as one number that sorts in that order
+    static uint32_t situationKey(uint64_t word);
+
+    //the toGo of a situation key starts at this bit, below it are the yardLine and seconds
+    static constexpr int TO_GO_KEY_SHIFT = 17;
+
+    //adds the outcomes of a word to the totals if matched is 1
+    static void addOutcomes(PackedTotals& totals, uint64_t word, uint64_t matched);
+
+    //indices of the plays within the bounds
+    vector<int> matchingRows(const SituationBounds& bounds) const;
+
+    //counts the plays within the bounds and their outcomes without looking at the plays
+    PackedTotals aggregate(const SituationBounds& bounds) const;
+
+    const vector<uint64_t>& getWords() const;
+
+    int bytesPerPlay() const;
+
+
+    //bytes held by its arrays, for the memory report
+    long memoryBytes() const;
+
+private:
+    vector<uint64_t> words;
+
+    static constexpr int SEASON_BASE = 1970;
+};
@@ -6,7 +6,13 @@ using namespace std;
 
 Play::Play(){
     gameID = 0;
+    fileIndex = 0;
+    fileRow = 0;
     gameDate = "";
+    dateAsInt = 0;
+    season = 0;
+    gameDay = 0;
+    ageInDays = 0;
     quarter = -1;
     minutes = 0;
     seconds = 0;
@@ -38,5 +44,26 @@ Play::Play(){
     isTwoPointConversionSuccessful = false;
     twoPointWeight = 0.0f;
     rushDirection = 0.0f;
+    isPunt = false;
+    rating = 0;
+    playTypeCode = 0;
+    passTypeCode = 0;
+    rushDirectionCode = 0;
+    formationCode = 0;
+    offenseCode = 0;
+    defenseCode = 0;
+    outcomes = 0;
+    kickResult = NO_KICK;
+    kickDistance = 0;
+    twoPointMethod = NO_TWO_POINT_METHOD;
+    penaltyFlags = 0;
     next = nullptr;
 }
+
+
+bool Play::ingestedBefore(const Play& other) const {
+    if (fileIndex != other.fileIndex) {
+        return fileIndex < other.fileIndex;
+    }
+    return fileRow < other.fileRow;
+}
@@ -5,11 +5,56 @@
 using namespace std;
 
 
+//bits of Play::outcomes, each a success the likelihoods count
+enum PlayOutcome {
+    FIRST_DOWN_OUTCOME = 1,
+    TOUCHDOWN_OUTCOME = 2,
+    FIELD_GOAL_OUTCOME = 4,
+    TWO_POINT_OUTCOME = 8
+};
+
+
+//how a field goal or extra point try ended, parsed from the description at ingest
+enum KickResult {
+    NO_KICK,
+    KICK_GOOD,
+    KICK_MISSED,
+    KICK_BLOCKED
+};
+
+
+//how a two point conversion was tried, the columns don't say so it is parsed from the description at ingest
+enum TwoPointMethod {
+    NO_TWO_POINT_METHOD,
+    TWO_POINT_PASS,
+    TWO_POINT_RUSH
+};
+
+
+//bits of Play::penaltyFlags
+enum PenaltyFlag {
+    PENALTY_FLAG = 1,
+    PENALTY_DECLINED = 2,
+    PENALTY_OFFSETTING = 4,
+    PLAY_NULLIFIED = 8
+};
+
+
 //represents a play
 struct Play {
     Play* next;
     int gameID;
+    //position of the play's file among the files read and its line in that file
+    //plays of a game that share a clock keep the order they were played in, and equally rated plays are broken by it
+    int fileIndex;
+    int fileRow;
     string gameDate;
+    //gameDate as yyyymmdd and the season it belongs to, filled in at ingest
+    int dateAsInt;
+    int season;
+    //days since 1970-01-01 and days before the latest game that was read
+    int gameDay;
+    int ageInDays;
     int quarter;
     int minutes;
     int seconds;
@@ -41,10 +86,32 @@ struct Play {
     bool isTwoPointConversionSuccessful;
     float twoPointWeight;
     string rushDirection;
+    //only read when the ingest configuration keeps punts, which neither data structure holds (see Dataset::buildShared)
+    bool isPunt;
+    //fixed-point rating computed once at ingest (see Helpers::calculateRating)
+    int rating;
+    //dictionary codes assigned at ingest (see PlayDictionary)
+    int playTypeCode;
+    int passTypeCode;
+    int rushDirectionCode;
+    int formationCode;
+    int offenseCode;
+    int defenseCode;
+    //PlayOutcome bits derived at ingest so likelihoods can be summed without branching
+    unsigned char outcomes;
+    //parsed from the description at ingest (see DescriptionFeatures) so queries never search the text
+    unsigned char kickResult;
+    //yards of a field goal try, 0 if the description doesn't say
+    unsigned char kickDistance;
+    unsigned char twoPointMethod;
+    unsigned char penaltyFlags;
 
 
 public:
     Play();
 
     bool operator==(const Play& comparedPlay);
+
+    //checks if the play was read before the other one, so every data structure breaks rating ties the same way
+    bool ingestedBefore(const Play& other) const;
 };
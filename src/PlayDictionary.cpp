@@ -0,0 +1,103 @@
+#include "PlayDictionary.h"
+
+
+using namespace std;
+
+
+vector<string> PlayDictionary::values[PlayDictionary::FIELD_COUNT] = {{""}, {""}, {""}};
+unordered_map<string, int> PlayDictionary::codes[PlayDictionary::FIELD_COUNT] = {{{"", 0}}, {{"", 0}}, {{"", 0}}};
+mutex PlayDictionary::dictionaryMutex;
+
+
+int PlayDictionary::encode(Field field, const string& value) {
+    lock_guard<mutex> lock(dictionaryMutex);
+    return encodeLocked(field, value);
+}
+
+
+int PlayDictionary::encodeLocked(Field field, const string& value) {
+    auto iter = codes[field].find(value);
+    if (iter != codes[field].end()) {
+        return iter->second;
+    }
+
+    //keeps codes inside the dense arrays if the data has more values than expected
+    if (static_cast<int>(values[field].size()) >= capacity(field)) {
+        return capacity(field) - 1;
+    }
+
+    //reserves the full capacity so references returned by decode stay valid
+    values[field].reserve(capacity(field));
+    int code = static_cast<int>(values[field].size());
+    values[field].push_back(value);
+    codes[field][value] = code;
+    return code;
+}
+
+
+int PlayDictionary::lookup(Field field, const string& value) {
+    lock_guard<mutex> lock(dictionaryMutex);
+
+    auto iter = codes[field].find(value);
+    if (iter == codes[field].end()) {
+        return -1;
+    }
+    return iter->second;
+}
+
+
+const string& PlayDictionary::decode(Field field, int code) {
+    lock_guard<mutex> lock(dictionaryMutex);
+    return values[field][code];
+}
+
+
+int PlayDictionary::size(Field field) {
+    lock_guard<mutex> lock(dictionaryMutex);
+    return static_cast<int>(values[field].size());
+}
+
+
+//locks once per play since files are read in parallel
+void PlayDictionary::encodePlay(Play& play) {
+    lock_guard<mutex> lock(dictionaryMutex);
+    play.playTypeCode = encodeLocked(PLAY_TYPE, play.playType);
+    play.passTypeCode = encodeLocked(SUB_TYPE, play.passType);
+    play.rushDirectionCode = encodeLocked(SUB_TYPE, play.rushDirection);
+    play.formationCode = encodeLocked(SUB_TYPE, play.formation);
+    //successful two point conversions are tallied under the sub play PASS or RUSH, so those codes exist once one is read
+    if (play.twoPointMethod == TWO_POINT_PASS) {
+        encodeLocked(SUB_TYPE, "PASS");
+    }
+    else if (play.twoPointMethod == TWO_POINT_RUSH) {
+        encodeLocked(SUB_TYPE, "RUSH");
+    }
+    play.offenseCode = encodeLocked(TEAM, play.offense);
+    play.defenseCode = encodeLocked(TEAM, play.defense);
+}
+
+
+//counts each value twice, once in values and once as a key of codes
+long PlayDictionary::memoryBytes() {
+    lock_guard<mutex> lock(dictionaryMutex);
+    long bytes = 0;
+    for (int field = 0; field < FIELD_COUNT; field++) {
+        bytes += static_cast<long>(values[field].capacity() * sizeof(string));
+        bytes += static_cast<long>(codes[field].bucket_count() * sizeof(void*));
+        for (const string& value : values[field]) {
+            bytes += 2 * static_cast<long>(sizeof(string) + value.size()) + static_cast<long>(sizeof(int) + sizeof(void*));
+        }
+    }
+    return bytes;
+}
+
+
+int PlayDictionary::capacity(Field field) {
+    if (field == PLAY_TYPE) {
+        return MAX_PLAY_TYPES;
+    }
+    if (field == TEAM) {
+        return MAX_TEAMS;
+    }
+    return MAX_SUB_TYPES;
+}
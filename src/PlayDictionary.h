@@ -0,0 +1,57 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+
+
+#include "Play.h"
+
+
+using namespace std;
+
+
+//assigns small integer codes to low-cardinality strings at ingest so queries never compare strings
+//code 0 is always the empty string
+class PlayDictionary {
+public:
+    enum Field {
+        PLAY_TYPE,
+        //passType, rushDirection, formation, and the PASS/RUSH of two point conversions share codes
+        SUB_TYPE,
+        //offense and defense share codes
+        TEAM,
+        FIELD_COUNT
+    };
+
+    //fixed capacities so tallies can be dense arrays indexed by code
+    static constexpr int MAX_PLAY_TYPES = 64;
+    static constexpr int MAX_SUB_TYPES = 128;
+    static constexpr int MAX_TEAMS = 128;
+
+    //returns the code of a value, adding it if it hasn't been seen (values past capacity share the last code)
+    static int encode(Field field, const string& value);
+
+    //returns the code of a value or -1 if it hasn't been seen
+    static int lookup(Field field, const string& value);
+
+    static const string& decode(Field field, int code);
+
+    static int size(Field field);
+
+    //fills in every code of a play from its strings
+    static void encodePlay(Play& play);
+
+    //bytes held by the values and codes of every field
+    static long memoryBytes();
+
+private:
+    static int capacity(Field field);
+
+    //encode without taking the lock, for callers that already hold it
+    static int encodeLocked(Field field, const string& value);
+
+    static vector<string> values[FIELD_COUNT];
+    static unordered_map<string, int> codes[FIELD_COUNT];
+    static mutex dictionaryMutex;
+};
@@ -1,12 +1,13 @@
 #include <iostream>
 #include <fstream>
-#include <sstream>
 #include <queue>
-#include <map>
+#include <algorithm>
 
 
 #include "PlayHashTable.h"
-#include "ComparePlay.h"
+#include "SuccessTally.h"
+#include "PlayIngest.h"
+#include "ConfidenceIntervals.h"
 
 
 using namespace std;
@@ -18,111 +19,25 @@ PlayHashTable::PlayHashTable(unsigned long initialCapacity) {
 }
 
 
-void PlayHashTable::readDataAndPushIntoHashMap(const string &filename, vector<LinkedList>& ht) {
-
-    ifstream file(filename);
-
-    if (!file.is_open()) {
-        cerr << "Could not open file: " << filename << endl;
-        return;
-    }
+IngestStats PlayHashTable::readDataAndPushIntoHashMap(const string &path, vector<LinkedList>& ht, const IngestConfig& config) {
+    //every file of a directory of seasons is read in parallel
+    vector<Play> plays;
+    IngestStats stats = PlayIngest::readFiles(PlayIngest::listDataFiles(path), config, plays);
+    pushIntoHashMap(plays, ht);
+    return stats;
+}
 
-    string line;
-    getline(file, line);
-    int i = 0;
 
+//takes over already parsed plays, like the ones a background preload read
+void PlayHashTable::pushIntoHashMap(vector<Play>& plays, vector<LinkedList>& ht) {
     //used for rehashing
     int count = 0;
     const double loadFactor = 0.7;
 
     PlayHashTable hashObject(500);
 
-    while (getline(file, line)) {
-        stringstream ss(line);
-        string token;
-
-        Play* play = new Play();
-        try {
-            getline(ss, token, ',');  // read gameID
-            play->gameID = stoi(token);
-            getline(ss, token, ',');  // read gameDate
-            play->gameDate = token;
-            getline(ss, token, ',');  // read quarter
-            play->quarter = stoi(token);
-            getline(ss, token, ',');  // read minute
-            play->minutes = stoi(token);
-            getline(ss, token, ',');  // read second
-            play->seconds = stoi(token);
-            play->timeAsInt = Helpers::timeToInt(play->minutes, play->seconds);
-            getline(ss, token, ',');  // read offense
-            play->offense = token;
-            getline(ss, token, ',');  // read defense
-            play->defense = token;
-            getline(ss, token, ',');  // read down
-            play->down = stoi(token);
-            getline(ss, token, ',');  // read toGo
-            play->toGo = stoi(token);
-            getline(ss, token, ',');  // read yardLine
-            play->yardLine = stoi(token);
-            getline(ss, token, ',');  // read if result is first down
-            play->resultIsFirstDown = Helpers::booleanResult(stoi(token));
-            getline(ss, token, ',');  // read description
-            play->description = token;
-            getline(ss, token, ',');  // read resultingYards
-            play->resultingYards = stoi(token);
-            play->yardsWeight = Helpers::calculateWeight(play->resultingYards);
-            getline(ss, token, ',');  // read formation
-            play->formation = token;
-            getline(ss, token, ',');  // read playType
-            const string playType = token;
-            // skip unwanted play types to keep the hash table lean
-            if(playType.empty() || playType == "NO PLAY" || playType == "TIMEOUT" ||
-               playType == "KICK OFF" || playType == "PUNT" || playType == "EXTRA POINT" ||
-               playType == "QB KNEEL"){
-                delete play;
-                continue;
-            }
-            play->playType = playType;
-            getline(ss, token, ',');  // read if isRush
-            play->isRush = Helpers::booleanResult(stoi(token));
-            getline(ss, token, ',');  // read if isPass
-            play->isPass = Helpers::booleanResult(stoi(token));
-            getline(ss, token, ',');  // read if isIncomplete
-            play->isIncomplete = Helpers::booleanResult(stoi(token));
-            getline(ss, token, ',');  // read if isTouchdown
-            play->isTouchdown = Helpers::booleanResult(stoi(token));
-            if (play->isTouchdown) {
-                play->touchdownWeight = 10.0f;
-            }
-            getline(ss, token, ',');  // read passType
-            play->passType = token;
-            getline(ss, token, ',');  // read if isSack
-            play->isSack = Helpers::booleanResult(stoi(token));
-            getline(ss, token, ',');  // read if isInterception
-            play->isInterception = Helpers::booleanResult(stoi(token));
-            if (play->isInterception) {
-                play->interceptionWeight = -100.0f;
-            }
-            getline(ss, token, ',');  // read if isFumble
-            play->isFumble = Helpers::booleanResult(stoi(token));
-            if (play->isFumble) {
-                play->fumbleWeight = -1000.0f;
-            }
-            getline(ss, token, ',');  // read if isTwoPointConversion
-            play->isTwoPointConversion = Helpers::booleanResult(stoi(token));
-            getline(ss, token, ',');  // read if isTwoPointConversionSuccessful
-            play->isTwoPointConversionSuccessful = Helpers::booleanResult(stoi(token));
-            if (play->isTwoPointConversionSuccessful) {
-                play->twoPointWeight = 5.0f;
-            }
-            getline(ss, token, ',');  // read rushDirection
-            play->rushDirection = token;
-            i++;
-        }
-            //helps for debugging file
-        catch (exception& err) {
-            cout << "Error: " << err.what() << " at line " << i << endl;
-        }
+    for (Play& readPlay : plays) {
+        Play* play = new Play(std::move(readPlay));
 
         //put into hash table
         string playCode = Helpers::generatePlayCode(*play);
@@ -137,345 +52,290 @@ void PlayHashTable::readDataAndPushIntoHashMap(const string &filename, vector<Li
         ht.at(hashCode).LinkedList::insert(play);
         count++;
     }
-    file.close();
+
+    summarizeBuckets(ht);
+    plays.clear();
 }
 
 
 //gives result based on given current situation and all given situations for hashTable
-void PlayHashTable::suggestPlayFromHashTable(const Play& currentSituation, priority_queue<Play, vector<Play>, ComparePlay>& hashMaxHeap) {
-    //copies it so that the heap can be reused multiple times each run
-    priority_queue<Play, vector<Play>, ComparePlay> modifiableHeap = hashMaxHeap;
-    Play bestPlay = modifiableHeap.top();
-
-    //stores similar situations
-    priority_queue<Play, vector<Play>, ComparePlay> tempHeap;
-
-    //initialize bounds
-    int toGoLowerBound;
-    int toGoUpperBound;
-    int yardLineLowerBound;
-    int yardLineUpperBound;
-
-    //handles if it is not determining a 2 point conversion
-    if (currentSituation.down != 0) {
-        //bounds for toGo have 1 yard leeway
-        toGoLowerBound = Helpers::calculateToGoBounds(currentSituation.toGo)[0];
-        toGoUpperBound = Helpers::calculateToGoBounds(currentSituation.toGo)[1];
-
-        //bounds for yardLine have 5 yard leeway
-        yardLineLowerBound = Helpers::calculateYardLineBounds(currentSituation.yardLine)[0];
-        yardLineUpperBound = Helpers::calculateYardLineBounds(currentSituation.yardLine)[1];
-    }
-    //if it is determining a 2 point conversion
-    else {
-        toGoLowerBound = 0;
-        toGoUpperBound = 0;
-        yardLineLowerBound = 98;
-        yardLineUpperBound = 99;
+//buckets fully covered by the bounds use their summaries, only partially covered ones filter their plays
+void PlayHashTable::suggestPlayFromHashTable(const Play& currentSituation, vector<LinkedList>& ht, const QueryOptions& options) {
+    //toGo has 1 yard leeway, yardLine has 5 yards leeway, and time has 1:30 leeway unless the window is adaptive
+    SituationBounds bounds = Helpers::calculateSituationBounds(currentSituation, options.seasons);
+    if (options.targetSample > 0 && !counts.empty()) {
+        AdaptiveWindow window = counts.adapt(currentSituation, options.seasons, options.targetSample);
+        window.print();
+        bounds = window.bounds;
     }
 
-    //bounds for time always have 1:30 leeway
-    int timeLowerBound = Helpers::calculateTimeBounds(currentSituation.minutes, currentSituation.seconds)[0];
-    int timeUpperBound = Helpers::calculateTimeBounds(currentSituation.minutes, currentSituation.seconds)[1];
-
-    //initialize counters
-    int firstDowns = 0;
-    int touchdowns = 0;
-    int conversions = 0;
-    int fieldGoals = 0;
-    int firstDownPasses = 0;
-    int firstDownRushes = 0;
-    int touchdownPasses = 0;
-    int touchdownRushes = 0;
-    int twoPointPasses = 0;
-    int twoPointRushes = 0;
-
-    //map<playType, map<subPlayType, numOfSuccesses>>
-    map<string, map<string,int>> playTypeSuccessMap = {};
-
-    while (!modifiableHeap.empty()) {
-        Play currentPlay = modifiableHeap.top();
-
-        modifiableHeap.pop();
-
-        //checks if quarter and down are same, toGo is within 1 yard inclusive
-        //yardLine is within 5 yards inclusive, and time is within 1:30 inclusive
-        //then adds current iteration of play into tempHeap if all are true
-        if (currentPlay.quarter == currentSituation.quarter && currentPlay.down == currentSituation.down
-            && currentPlay.toGo >= toGoLowerBound && currentPlay.toGo <= toGoUpperBound
-            && currentPlay.yardLine >= yardLineLowerBound && currentPlay.yardLine <= yardLineUpperBound
-            && currentPlay.timeAsInt >= timeLowerBound && currentPlay.timeAsInt <= timeUpperBound) {
-
-            tempHeap.push(currentPlay);
-
-            //if it's determining a two point conversion
-            if (currentSituation.isTwoPointConversion && currentPlay.isTwoPointConversion && currentPlay.playType != "EXTRA POINT") {
-
-                //calculating likelihood of successful conversion in situation
-                if (currentPlay.isTwoPointConversionSuccessful) {
-                    conversions++;
-                    //from https://stackoverflow.com/questions/2340281/check-if-a-string-contains-a-string-in-c
-                    //uses this because .csv doesn't specify if pass or rush directly if it's a conversion
-                    if (currentPlay.description.find("PASS") != string::npos) {
-                        twoPointPasses++;
-                        playTypeSuccessMap[currentPlay.playType]["PASS"]++;  //for specific formation
-                    }
-                    else if (currentPlay.description.find("RUSH") != string::npos) {
-                        twoPointRushes++;
-                        playTypeSuccessMap[currentPlay.playType]["RUSH"]++;  //for specific formation
-                    }
-                }
+    //summaries whose plays are all similar situations
+    vector<const BucketSummary*> coveredSummaries;
+    //similar situations from summaries that are only partially covered
+    vector<const Play*> matches;
+    //dense array of the best candidate ratings for finding the best play
+    vector<const Play*> candidates;
+    vector<int> candidateRatings;
+
+    //counts outcomes of similar situations
+    SuccessTally tally;
+
+    //custom weights rate only the similar situations, the summaries stay ordered by the ratings from ingest
+    bool customWeights = !options.weights.isDefault();
+
+    vector<string> playCodes = Helpers::generatePlayCodes(bounds);
+    vector<int> indices = probeIndices(bounds, ht);
+    for (int i = 0; i < static_cast<int>(indices.size()); i++) {
+        //starts loading the play code and bounds of every summary of the next bucket while this one is read
+        //those are what each summary is checked against, the tallies of covered summaries are still loaded when merged
+#if defined(__GNUC__)
+        if (i + 1 < static_cast<int>(indices.size())) {
+            for (const BucketSummary& summary : ht[indices[i + 1]].summaries) {
+                __builtin_prefetch(&summary.playCode);
+                __builtin_prefetch(&summary.maxSeason);
+            }
+        }
+#endif
+        int index = indices[i];
+        for (const BucketSummary& summary : ht[index].summaries) {
+            //skips codes that only share the bucket because of a collision
+            if (find(playCodes.begin(), playCodes.end(), summary.playCode) == playCodes.end()) {
+                continue;
+            }
+            //skips summaries with no plays from the seasons asked for
+            if (!summary.overlapsSeasons(bounds)) {
+                continue;
             }
-                //if it's not determining a two point conversion
-            else {
-                if (currentSituation.isTwoPointConversion && currentPlay.playType == "PASS") {
-                    cout << currentPlay.playType << ": " << currentPlay.description << endl;
-                }
 
-                //calculating likelihood of first down in situation
-                if (currentPlay.resultIsFirstDown) {
-                    firstDowns++;
-                    if (currentPlay.isPass) {
-                        firstDownPasses++;
-                        playTypeSuccessMap[currentPlay.playType][currentPlay.passType]++;  //for specific pass type
-                    }
-                    else if (currentPlay.isRush) {
-                        firstDownRushes++;
-                        playTypeSuccessMap[currentPlay.playType][currentPlay.rushDirection]++;  //for specific rush dir
-                    }
+            if (summary.isCoveredBy(bounds)) {
+                coveredSummaries.push_back(&summary);
+                tally.merge(currentSituation.isTwoPointConversion ? summary.twoPointTally : summary.tally);
+                if (!customWeights) {
+                    candidates.push_back(summary.byRating.front());
+                    candidateRatings.push_back(summary.byRating.front()->rating);
+                    continue;
                 }
-
-                //calculating likelihood of TD in situation
-                if (currentPlay.isTouchdown) {
-                    touchdowns++;
-                    if (currentPlay.isPass) {
-                        touchdownPasses++;
-                        playTypeSuccessMap[currentPlay.playType][currentPlay.passType]++;  //for specific pass type
-                    } else if (currentPlay.isRush) {
-                        touchdownRushes++;
-                        playTypeSuccessMap[currentPlay.playType][currentPlay.rushDirection]++;  //for specific rush dir
+                //the play with the highest custom rating, read first among equals like the front is for the ratings from ingest
+                const Play* best = nullptr;
+                int bestRating = 0;
+                for (const Play* play : summary.byRating) {
+                    int rating = options.weights.rating(*play);
+                    if (best == nullptr || rating > bestRating || (rating == bestRating && play->ingestedBefore(*best))) {
+                        best = play;
+                        bestRating = rating;
                     }
                 }
+                candidates.push_back(best);
+                candidateRatings.push_back(bestRating);
+                continue;
+            }
 
-                //calculating likelihood of successful field goal in situation
-                if (currentPlay.playType == "FIELD GOAL") {
-                    //from https://stackoverflow.com/questions/2340281/check-if-a-string-contains-a-string-in-c
-                    //uses this because .csv file doesn't directly specify if field goal is good or not
-                    if (currentPlay.description.find("IS GOOD") != string::npos) {
-                        fieldGoals++;
-                        playTypeSuccessMap[currentPlay.playType][currentPlay.formation]++; //for specific formation
-                    }
+            //only the slice of plays within the yardLine bounds needs to be filtered
+            auto start = lower_bound(summary.byPosition.begin(), summary.byPosition.end(), bounds.yardLineLowerBound,
+                                     [](const Play* play, int yardLine) { return play->yardLine < yardLine; });
+            for (auto iter = start; iter != summary.byPosition.end() && (*iter)->yardLine <= bounds.yardLineUpperBound; iter++) {
+                const Play& currentPlay = **iter;
+                if (bounds.matches(currentPlay)) {
+                    matches.push_back(&currentPlay);
+                    candidates.push_back(&currentPlay);
+                    candidateRatings.push_back(customWeights ? options.weights.rating(currentPlay) : currentPlay.rating);
+
+                    tally.add(currentPlay, currentSituation.isTwoPointConversion);
                 }
             }
         }
     }
 
     //if there are no similar situations within bounds given
-    if (tempHeap.empty()) {
+    if (tally.situations == 0) {
+        if (options.nearestNeighbors > 0 && !neighbors.empty()) {
+            cout << "No Match Found! Using the most similar situations instead.\n";
+            SituationKdTree::printNeighbors(currentSituation, neighbors.nearest(currentSituation, bounds, options.nearestNeighbors));
+            return;
+        }
         cout << "No Match Found! Good Luck!\n\n";
         return;
     }
+    //the best play is the highest rating among the similar situations
+    const Play& bestPlay = *candidates[Helpers::bestRatedIndex(candidateRatings, candidates)];
+
     //if there is a similar situation but the attempt was unsuccessful
-    if (tempHeap.top().isIncomplete || tempHeap.top().isInterception || tempHeap.top().resultingYards < 0) {
-        if (tempHeap.size() > 1) {
+    if (bestPlay.isIncomplete || bestPlay.isInterception || bestPlay.resultingYards < 0) {
+        if (tally.situations > 1) {
             cout << "Matches found, but with no gain. Here are their game IDs:\n";
-            for (int i = 0; i < tempHeap.size(); i++) {
-                cout << tempHeap.top().gameID << endl;
-                tempHeap.pop();
+            for (const BucketSummary* summary : coveredSummaries) {
+                for (const Play* play : summary->byRating) {
+                    cout << play->gameID << endl;
+                }
+            }
+            for (const Play* match : matches) {
+                cout << match->gameID << endl;
             }
         }
         else {
             cout << "Match found, but with no gain. Here is its game ID:\n";
-            cout << tempHeap.top().gameID << endl;
+            cout << bestPlay.gameID << endl;
         }
         cout << endl;
         return;
     }
 
-    //the best play is at the top of the max Heap depending on rating given by ComparePlay
-    bestPlay = tempHeap.top();
-
-    map<string, float> likelihoods;
-
-    //likelihoods for first downs
-    float likelihoodFirstDown = (static_cast<float>(firstDowns)/static_cast<float>(tempHeap.size()))*100;
-    //puts likelihood of first down into map that's unsorted by likelihood
-    likelihoods["First Down: "] = likelihoodFirstDown;
-    float likelihoodFirstDownPass = 0;
-    float likelihoodFirstDownRush = 0;
-    //so that it doesn't divide by 0
-    if (firstDowns != 0) {
-        likelihoodFirstDownPass = (static_cast<float>(firstDownPasses)/static_cast<float>(firstDowns))*100;
-        likelihoodFirstDownRush = (static_cast<float>(firstDownRushes)/static_cast<float>(firstDowns))*100;
+    //recent seasons and intervals need every matched play, including the plays of covered summaries
+    vector<const Play*> allMatches;
+    if (options.halfLifeSeasons > 0 || options.confidenceIntervals) {
+        allMatches = matches;
+        for (const BucketSummary* summary : coveredSummaries) {
+            allMatches.insert(allMatches.end(), summary->byRating.begin(), summary->byRating.end());
+        }
     }
-
-    //likelihoods for touchdowns
-    float likelihoodTouchdown = (static_cast<float>(touchdowns)/static_cast<float>(tempHeap.size()))*100;
-    //puts likelihood of touchdown into map that's unsorted by likelihood
-    likelihoods["Touchdown: "] = likelihoodTouchdown;
-    float likelihoodTouchdownPass = 0;
-    float likelihoodTouchdownRush = 0;
-    //so that it doesn't divide by 0
-    if (touchdowns != 0) {
-        likelihoodTouchdownPass = (static_cast<float>(touchdownPasses)/static_cast<float>(touchdowns))*100;
-        likelihoodTouchdownRush = (static_cast<float>(touchdownRushes)/static_cast<float>(touchdowns))*100;
+    WeightedRates weighted;
+    if (options.halfLifeSeasons > 0) {
+        weighted = RecencyWeighting::compute(allMatches, options.halfLifeSeasons);
     }
-
-    //likelihoods for conversions
-    float likelihoodTwoPoint = (static_cast<float>(conversions)/static_cast<float>(tempHeap.size()))*100;
-    //likelihood of conversion not into map because if calculating for conversion, will be the only one printed
-    //...so it will not need to be sorted
-    float likelihoodTwoPointPass = 0;
-    float likelihoodTwoPointRush = 0;
-    //so that it doesn't divide by 0
-    if (conversions != 0) {
-        likelihoodTwoPointPass = (static_cast<float>(twoPointPasses)/static_cast<float>(conversions))*100;
-        likelihoodTwoPointRush = (static_cast<float>(twoPointRushes)/static_cast<float>(conversions))*100;
+    LikelihoodIntervals intervals;
+    if (options.confidenceIntervals) {
+        intervals = ConfidenceIntervals::compute(allMatches, tally, currentSituation.isTwoPointConversion, options.latencyBudgetMs);
     }
+    tally.printSuggestion(currentSituation, bestPlay, options.halfLifeSeasons > 0 ? &weighted : nullptr,
+                          options.confidenceIntervals ? &intervals : nullptr);
+}
 
-    //likelihood for field goals
-    float likelihoodFieldGoal = 0.0f;
-    //so that it doesn't divide by 0
-    if (fieldGoals != 0) {
-        likelihoodFieldGoal = (static_cast<float>(fieldGoals)/static_cast<float>(tempHeap.size()))*100;
-    }
-    //puts likelihood of field goal into map that's unsorted by likelihood
-    likelihoods["Field Goal: "] = likelihoodFieldGoal;
 
+//groups the plays of each bucket by play code and computes their summaries once after reading
+void PlayHashTable::summarizeBuckets(vector<LinkedList>& ht) {
+    for (LinkedList& bucket : ht) {
+        bucket.summaries.clear();
+
+        //map<playCode, index of summary in bucket>
+        unordered_map<string, int> summaryIndices;
+        for (Play* play = bucket.head; play != nullptr; play = play->next) {
+            string playCode = Helpers::generatePlayCode(*play);
+            auto found = summaryIndices.find(playCode);
+            if (found == summaryIndices.end()) {
+                found = summaryIndices.insert({playCode, static_cast<int>(bucket.summaries.size())}).first;
+                bucket.summaries.emplace_back();
+                BucketSummary& summary = bucket.summaries.back();
+                summary.playCode = playCode;
+                summary.minQuarter = summary.maxQuarter = play->quarter;
+                summary.minDown = summary.maxDown = play->down;
+                summary.minToGo = summary.maxToGo = play->toGo;
+                summary.minYardLine = summary.maxYardLine = play->yardLine;
+                summary.minTime = summary.maxTime = play->timeAsInt;
+                summary.minSeason = summary.maxSeason = play->season;
+            }
 
-    //logic for multimap inspired by https://www.educative.io/answers/how-to-sort-a-map-by-value-in-cpp
-    //is so that the likelihoods map can be sorted by value
-    //logic of descending sorted map from https://www.geeksforgeeks.org/descending-order-map-multimap-c-stl/
-    multimap<float, string, greater<float>> sortedLikelihoods;
-    //will sort the likelihoods map by the key's value
-    for (auto iter = likelihoods.begin(); iter != likelihoods.end(); iter++) {
-        sortedLikelihoods.insert({iter->second, iter->first});
-    }
+            BucketSummary& summary = bucket.summaries[found->second];
+            summary.minQuarter = min(summary.minQuarter, play->quarter);
+            summary.maxQuarter = max(summary.maxQuarter, play->quarter);
+            summary.minDown = min(summary.minDown, play->down);
+            summary.maxDown = max(summary.maxDown, play->down);
+            summary.minToGo = min(summary.minToGo, play->toGo);
+            summary.maxToGo = max(summary.maxToGo, play->toGo);
+            summary.minYardLine = min(summary.minYardLine, play->yardLine);
+            summary.maxYardLine = max(summary.maxYardLine, play->yardLine);
+            summary.minTime = min(summary.minTime, play->timeAsInt);
+            summary.maxTime = max(summary.maxTime, play->timeAsInt);
+            summary.minSeason = min(summary.minSeason, play->season);
+            summary.maxSeason = max(summary.maxSeason, play->season);
+
+            summary.tally.add(*play, false);
+            summary.twoPointTally.add(*play, true);
+            summary.byRating.push_back(play);
+            summary.byPosition.push_back(play);
+        }
 
-    int mostSuccesses = -1;
-    //map<amtOfSuccess, map<playType, subPlayType>>
-    //logic of descending sorted map from https://www.geeksforgeeks.org/descending-order-map-multimap-c-stl/
-    map<int, pair<string, string>, greater<int>> successfulPlayMap = {};
-
-    //puts successful play(s) into separate map
-    //keeps 1 if it has the most successes and keeps multiple if successes are the same for 2 different plays
-    for (auto iter = playTypeSuccessMap.begin(); iter != playTypeSuccessMap.end(); iter++) {
-        for (auto iter2 = iter->second.begin(); iter2 != iter->second.end(); iter2++) {
-            if (iter2->second > mostSuccesses) {
-                successfulPlayMap[iter2->second] = {iter->first, iter2->first};
-                mostSuccesses = iter2->second;
-            }
+        for (BucketSummary& summary : bucket.summaries) {
+            summary.tally.compact();
+            summary.twoPointTally.compact();
+            //equal ratings are ordered by when they were read, so the front is the play the heap would pick
+            sort(summary.byRating.begin(), summary.byRating.end(), [](const Play* a, const Play* b) {
+                if (a->rating != b->rating) {
+                    return a->rating > b->rating;
+                }
+                return a->ingestedBefore(*b);
+            });
+            sort(summary.byPosition.begin(), summary.byPosition.end(), [](const Play* a, const Play* b) {
+                if (a->yardLine != b->yardLine) {
+                    return a->yardLine < b->yardLine;
+                }
+                return a->timeAsInt < b->timeAsInt;
+            });
         }
     }
+}
 
-    cout << "\nOUT OF " << tempHeap.size() << " SIMILAR SITUATIONS, ";
-    //if plural amount of successful plays
-    if (successfulPlayMap.size() > 1) {
-        cout << "THE IDEAL PLAYS' LIKELIHOODS ARE:\n";
-    }
-    else {
-        cout << "THE IDEAL PLAY'S LIKELIHOOD IS:\n";
-    }
 
+//builds the k-d tree over every play of the buckets, used when no situation is within the bounds
+void PlayHashTable::indexNeighbors(vector<LinkedList>& ht) {
+    neighbors.build(playPointers(ht));
+}
 
-    //prints ideal plays in descending order by iterating through map of occurrences with their respective plays
-    for (auto iter = successfulPlayMap.begin(); iter != successfulPlayMap.end(); iter++) {
-        float subPlayLikelihood = (static_cast<float>(iter->first)/static_cast<float>(tempHeap.size()))*100;
-        if (iter->second.first == "FIELD GOAL") {
-            cout << "    " << iter->second.first << " IN " << iter->second.second << " FORMATION: ";
-        }
-        else {
-            cout << "    " << iter->second.first << " " << iter->second.second << ": ";
-        }
-        cout << Helpers::formatPercentages(subPlayLikelihood) << "%\n";
-    }
 
-    cout << "\nLIKELIHOODS:\n";
+//builds the counts used to pick an adaptive window
+void PlayHashTable::indexCounts(vector<LinkedList>& ht) {
+    counts.build(playPointers(ht));
+}
 
-    //only prints 2 pt conversion if the inputted situation prompted for 2 pt conversion likelihood
-    if (currentSituation.isTwoPointConversion) {
-        cout << "    Two Point Conversion: " << Helpers::formatPercentages(likelihoodTwoPoint) << "%\n";
-        cout << "        Two Point Pass: " << Helpers::formatPercentages(likelihoodTwoPointPass) << "%\n";
-        cout << "        Two Point Rush: " << Helpers::formatPercentages(likelihoodTwoPointRush) << "%\n";
-    }
-    else {
-        //orders from greatest to least likelihoods in printing
-        for (auto iter = sortedLikelihoods.begin(); iter != sortedLikelihoods.end(); iter++) {
-            //ignores likelihoods of 0%
-            if (iter->first != 0) {
-                cout << "    " << iter->second << Helpers::formatPercentages(iter->first) << "%\n";
-                //if it's a first down
-                if (iter->second.find("Fir") != string::npos) {
-                    cout << "        Passing: " << Helpers::formatPercentages(likelihoodFirstDownPass) << "%\n";
-                    cout << "        Rushing: " << Helpers::formatPercentages(likelihoodFirstDownRush) << "%\n";
-                }
-                    //if it's a touchdown
-                else if (iter->second.find("To") != string::npos){
-                    cout << "        Passing: " << Helpers::formatPercentages(likelihoodTouchdownPass) << "%\n";
-                    cout << "        Rushing: " << Helpers::formatPercentages(likelihoodTouchdownRush) << "%\n";
-                }
-            }
+
+//points to every play of every bucket, for the indexes built over all plays
+vector<const Play*> PlayHashTable::playPointers(vector<LinkedList>& ht) {
+    vector<const Play*> pointers;
+    for (LinkedList& bucket : ht) {
+        for (Play* play = bucket.head; play != nullptr; play = play->next) {
+            pointers.push_back(play);
         }
     }
+    return pointers;
+}
 
-    cout << "\nBEST HISTORICAL PLAY: " << bestPlay.playType;
-    if (bestPlay.isPass) {
-        cout << " " << bestPlay.passType;
-    }
-    else if (bestPlay.isRush) {
-        cout << " " << bestPlay.rushDirection;
-    }
 
-    //if best play starts with a vowel
-    if (bestPlay.formation[0] == 'A' || bestPlay.formation[0] == 'E' || bestPlay.formation[0] == 'I'
-        || bestPlay.formation[0] == 'O' || bestPlay.formation[0] == 'U') {
-        cout << " with an " << bestPlay.formation << " formation\n";
-    }
-    else {
-        cout << " with a " << bestPlay.formation << " formation\n";
-    }
+MemoryReport PlayHashTable::memoryUsage(vector<LinkedList>& ht) const {
+    MemoryReport report;
+    report.title = "Hash table memory";
+    report.add("buckets", static_cast<long>(ht.capacity() * sizeof(LinkedList)));
 
-    //formatted output in paragraph form prints
-    cout << "    On " << bestPlay.gameDate << ", " << bestPlay.offense;
-    if (bestPlay.isTwoPointConversion && bestPlay.isTwoPointConversionSuccessful) {
-        cout << " scored 2 points ";
-        cout << "against " << bestPlay.defense << " during quarter " << bestPlay.quarter;
-        cout << " at time " << Helpers::formatTime(bestPlay.minutes, bestPlay.seconds) << ".\n";
-    }
-    else {
-        cout << " gained " << bestPlay.resultingYards << " yards ";
-        cout << "against " << bestPlay.defense << " during quarter " << bestPlay.quarter << " on down " << bestPlay.down;
-        cout << " on the " << bestPlay.yardLine << " yard line with " << bestPlay.toGo << " yards to go at time ";
-        cout << Helpers::formatTime(bestPlay.minutes, bestPlay.seconds) << ".\n";
-    }
-    cout << "The play ";
-    if (bestPlay.isTwoPointConversion) {
-        cout << "was a Two Point Conversion and was";
-        if (bestPlay.isTwoPointConversionSuccessful) {
-            cout << " ";
+    long playBytes = 0;
+    long summaryBytes = 0;
+    for (LinkedList& bucket : ht) {
+        for (Play* play = bucket.head; play != nullptr; play = play->next) {
+            playBytes += MemoryAccounting::playBytes(*play);
         }
-        else {
-            cout << "not ";
+        for (const BucketSummary& summary : bucket.summaries) {
+            summaryBytes += summary.memoryBytes();
         }
-        cout << "successful.";
     }
-    else {
-        if (bestPlay.isTouchdown) {
-            cout << "resulted in a touchdown.";
+    report.add("plays", playBytes);
+    report.add("bucket summaries", summaryBytes);
+    report.add("nearest neighbour tree", neighbors.memoryBytes());
+    report.add("window counts", counts.memoryBytes());
+    return report;
+}
+
+
+long PlayHashTable::evictColdFields(vector<LinkedList>& ht) {
+    long freed = 0;
+    for (LinkedList& bucket : ht) {
+        for (Play* play = bucket.head; play != nullptr; play = play->next) {
+            freed += MemoryAccounting::evictColdFields(*play);
         }
-        else {
-            cout << "did not result in a touchdown";
-            if (bestPlay.resultIsFirstDown) {
-                cout << ", but it did result in a first down.";
-            }
-            else {
-                cout << " or a first down.";
-            }
+    }
+    return freed;
+}
+
+
+//deletes every play and the indexes over them so the memory goes back before the other data structure is built
+void PlayHashTable::release(vector<LinkedList>& ht) {
+    for (LinkedList& bucket : ht) {
+        Play* play = bucket.head;
+        while (play != nullptr) {
+            Play* next = play->next;
+            delete play;
+            play = next;
         }
     }
-    cout << "\nDescription: " << bestPlay.description << endl;
-    cout << "Game ID: " << bestPlay.gameID << endl << endl;
-    cout << "\n============================================= Welcome back to the Gridiron Guru! ============================================\n";
+    vector<LinkedList>(ht.size()).swap(ht);
+    neighbors = SituationKdTree();
+    counts = SituationCounts();
 }
 
 
@@ -497,6 +357,19 @@ int PlayHashTable::hash_func(const std::string &playCode, vector<LinkedList>& ht
 }
 
 
+//lists the index of every bucket that overlaps the bounds of the current situation
+//different codes can hash to the same index, so each index is only listed once
+vector<int> PlayHashTable::probeIndices(const SituationBounds& bounds, vector<LinkedList>& ht) {
+    vector<int> indices;
+    for (const string& playCode : Helpers::generatePlayCodes(bounds)) {
+        indices.push_back(hash_func(playCode, ht));
+    }
+    sort(indices.begin(), indices.end());
+    indices.erase(unique(indices.begin(), indices.end()), indices.end());
+    return indices;
+}
+
+
 //for when the load factor exceeds the set load factor
 void PlayHashTable::rehash(vector<LinkedList>& ht, unsigned long newCapacity) {
     vector<LinkedList> newHashTable(newCapacity);
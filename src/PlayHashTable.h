@@ -1,3 +1,4 @@
+#pragma once
 #include <iostream>
 #include "LinkedList.h"
 #include <unordered_map>
@@ -5,7 +6,10 @@
 
 
 #include "Helpers.h"
-#include "ComparePlay.h"
+#include "PlayIngest.h"
+#include "SituationKdTree.h"
+#include "SituationCounts.h"
+#include "MemoryAccounting.h"
 
 
 using namespace std;
@@ -79,11 +83,46 @@ private:
 public:
     PlayHashTable(unsigned long initialCapacity);
 
-    static void readDataAndPushIntoHashMap(const string& filename, vector<LinkedList>& ht);
+    //reads a single .csv or every .csv of a directory of seasons
+    static IngestStats readDataAndPushIntoHashMap(const string& path, vector<LinkedList>& ht,
+                                                  const IngestConfig& config = IngestConfig::defaultConfig());
 
-    static void suggestPlayFromHashTable(const Play& currentSituation, priority_queue<Play, vector<Play>, ComparePlay>& maxHeap);
+    //moves already parsed plays into the buckets and summarizes them
+    static void pushIntoHashMap(vector<Play>& plays, vector<LinkedList>& ht);
+
+    //gives result based on given current situation and the buckets of the hash table that overlap it
+    void suggestPlayFromHashTable(const Play& currentSituation, vector<LinkedList>& ht,
+                                  const QueryOptions& options = QueryOptions());
+
+    //computes the summaries of every bucket once after reading
+    static void summarizeBuckets(vector<LinkedList>& ht);
 
     int hash_func(const std::string &playCode, vector<LinkedList>& ht);
 
+    //lists the index of every bucket that overlaps the bounds of the current situation
+    vector<int> probeIndices(const SituationBounds& bounds, vector<LinkedList>& ht);
+
     void rehash(vector<LinkedList>& ht, unsigned long newCapacity);
+
+    //builds the k-d tree over every play of the buckets, used when no situation is within the bounds
+    void indexNeighbors(vector<LinkedList>& ht);
+
+    //builds the counts used to pick an adaptive window
+    void indexCounts(vector<LinkedList>& ht);
+
+    //points to every play of every bucket, for the indexes built over all plays
+    static vector<const Play*> playPointers(vector<LinkedList>& ht);
+
+    //bytes held by the buckets, plays, summaries and indexes
+    MemoryReport memoryUsage(vector<LinkedList>& ht) const;
+
+    //drops the fields no query reads from every play, returns the bytes freed
+    static long evictColdFields(vector<LinkedList>& ht);
+
+    //deletes every play and the indexes over them so the memory goes back before the other data structure is built
+    void release(vector<LinkedList>& ht);
+
+private:
+    SituationKdTree neighbors;
+    SituationCounts counts;
 };
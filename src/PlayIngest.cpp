@@ -0,0 +1,337 @@
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <cstring>
+#include <cctype>
+#include <stdexcept>
+
+
+#include "PlayIngest.h"
+#include "PlayDictionary.h"
+#include "Helpers.h"
+#include "WorkerPool.h"
+#include "DescriptionFeatures.h"
+
+
+using namespace std;
+
+
+bool IngestConfig::materializes(PlayColumn column) const {
+    return (columns >> column) & 1u;
+}
+
+
+//every column, skipping the play types neither data structure suggests
+IngestConfig IngestConfig::defaultConfig() {
+    IngestConfig config;
+    config.columns = (1u << COLUMN_COUNT) - 1;
+    config.predicates.push_back({PLAY_TYPE, {"", "NO PLAY", "TIMEOUT", "KICK OFF", "PUNT", "EXTRA POINT", "QB KNEEL"}});
+    return config;
+}
+
+
+IngestConfig IngestConfig::withPunts() {
+    IngestConfig config = defaultConfig();
+    vector<string>& excluded = config.predicates[0].excludedValues;
+    excluded.erase(remove(excluded.begin(), excluded.end(), "PUNT"), excluded.end());
+    return config;
+}
+
+
+void IngestStats::merge(const IngestStats& other) {
+    filesRead += other.filesRead;
+    rowsRead += other.rowsRead;
+    rowsKept += other.rowsKept;
+    if (skippedRows.size() < other.skippedRows.size()) {
+        skippedRows.resize(other.skippedRows.size());
+    }
+    for (int i = 0; i < static_cast<int>(other.skippedRows.size()); i++) {
+        if (skippedRows[i].size() < other.skippedRows[i].size()) {
+            skippedRows[i].resize(other.skippedRows[i].size(), 0);
+        }
+        for (int j = 0; j < static_cast<int>(other.skippedRows[i].size()); j++) {
+            skippedRows[i][j] += other.skippedRows[i][j];
+        }
+    }
+}
+
+
+void IngestStats::print(const IngestConfig& config) const {
+    long rowsSkipped = rowsRead - rowsKept;
+    float skipRate = rowsRead == 0 ? 0.0f : (static_cast<float>(rowsSkipped)/static_cast<float>(rowsRead))*100;
+    cout << "Kept " << rowsKept << " of " << rowsRead << " rows from " << filesRead << (filesRead == 1 ? " file" : " files");
+    cout << ", skipped " << rowsSkipped;
+    cout << " (" << Helpers::formatPercentages(skipRate) << "%)";
+
+    for (int i = 0; i < static_cast<int>(skippedRows.size()); i++) {
+        for (int j = 0; j < static_cast<int>(skippedRows[i].size()); j++) {
+            if (skippedRows[i][j] == 0) {
+                continue;
+            }
+            const string& value = config.predicates[i].excludedValues[j];
+            cout << "\n    " << (value.empty() ? "(EMPTY)" : value) << ": " << skippedRows[i][j];
+        }
+    }
+    cout << endl;
+}
+
+
+//checks the predicate columns first and only splits the rest of the line if the row is kept
+bool PlayIngest::parseLine(const string& line, const IngestConfig& config, Play& play, IngestStats& stats) {
+    if (stats.skippedRows.size() < config.predicates.size()) {
+        stats.skippedRows.resize(config.predicates.size());
+        for (int i = 0; i < static_cast<int>(config.predicates.size()); i++) {
+            stats.skippedRows[i].resize(config.predicates[i].excludedValues.size(), 0);
+        }
+    }
+    stats.rowsRead++;
+
+    //fieldStarts[i] and fieldEnds[i] mark column i, found lazily so skipped rows stop early
+    const char* fieldStarts[COLUMN_COUNT];
+    const char* fieldEnds[COLUMN_COUNT];
+    const char* cursor = line.data();
+    const char* lineEnd = line.data() + line.size();
+    //carriage returns from files saved on Windows aren't part of the last column
+    if (lineEnd != cursor && *(lineEnd - 1) == '\r') {
+        lineEnd--;
+    }
+    int fieldsFound = 0;
+
+    auto findFieldsThrough = [&](int column) {
+        while (fieldsFound <= column) {
+            fieldStarts[fieldsFound] = cursor;
+            const char* comma = cursor < lineEnd ? static_cast<const char*>(memchr(cursor, ',', lineEnd - cursor)) : nullptr;
+            fieldEnds[fieldsFound] = comma == nullptr ? lineEnd : comma;
+            cursor = comma == nullptr ? lineEnd : comma + 1;
+            fieldsFound++;
+        }
+    };
+
+    //predicate columns are checked before anything is converted
+    for (int i = 0; i < static_cast<int>(config.predicates.size()); i++) {
+        const RowPredicate& predicate = config.predicates[i];
+        findFieldsThrough(predicate.column);
+        size_t length = fieldEnds[predicate.column] - fieldStarts[predicate.column];
+        for (int j = 0; j < static_cast<int>(predicate.excludedValues.size()); j++) {
+            const string& value = predicate.excludedValues[j];
+            if (value.size() == length && memcmp(value.data(), fieldStarts[predicate.column], length) == 0) {
+                stats.skippedRows[i][j]++;
+                return false;
+            }
+        }
+    }
+    stats.rowsKept++;
+
+    findFieldsThrough(COLUMN_COUNT - 1);
+    auto text = [&](PlayColumn column) {
+        return string(fieldStarts[column], fieldEnds[column]);
+    };
+    auto number = [&](PlayColumn column) {
+        return parseInt(fieldStarts[column], fieldEnds[column]);
+    };
+
+    if (config.materializes(GAME_ID)) play.gameID = number(GAME_ID);
+    if (config.materializes(GAME_DATE)) {
+        play.gameDate = text(GAME_DATE);
+        play.dateAsInt = Helpers::dateToInt(play.gameDate);
+        play.season = Helpers::seasonFromDate(play.dateAsInt);
+        play.gameDay = play.dateAsInt == 0 ? 0 : Helpers::dateToDay(play.dateAsInt);
+    }
+    if (config.materializes(QUARTER)) play.quarter = number(QUARTER);
+    if (config.materializes(MINUTE)) play.minutes = number(MINUTE);
+    if (config.materializes(SECOND)) play.seconds = number(SECOND);
+    play.timeAsInt = Helpers::timeToInt(play.minutes, play.seconds);
+    if (config.materializes(OFFENSE)) play.offense = text(OFFENSE);
+    if (config.materializes(DEFENSE)) play.defense = text(DEFENSE);
+    if (config.materializes(DOWN)) play.down = number(DOWN);
+    if (config.materializes(TO_GO)) play.toGo = number(TO_GO);
+    if (config.materializes(YARD_LINE)) play.yardLine = number(YARD_LINE);
+    if (config.materializes(IS_FIRST_DOWN)) play.resultIsFirstDown = Helpers::booleanResult(number(IS_FIRST_DOWN));
+    if (config.materializes(DESCRIPTION)) play.description = text(DESCRIPTION);
+    if (config.materializes(YARDS)) play.resultingYards = number(YARDS);
+    if (config.materializes(FORMATION)) play.formation = text(FORMATION);
+    if (config.materializes(PLAY_TYPE)) {
+        play.playType = text(PLAY_TYPE);
+        play.isPunt = play.playType == "PUNT";
+    }
+    if (config.materializes(IS_RUSH)) play.isRush = Helpers::booleanResult(number(IS_RUSH));
+    if (config.materializes(IS_PASS)) play.isPass = Helpers::booleanResult(number(IS_PASS));
+    if (config.materializes(IS_INCOMPLETE)) play.isIncomplete = Helpers::booleanResult(number(IS_INCOMPLETE));
+    if (config.materializes(IS_TOUCHDOWN)) play.isTouchdown = Helpers::booleanResult(number(IS_TOUCHDOWN));
+    if (config.materializes(PASS_TYPE)) play.passType = text(PASS_TYPE);
+    if (config.materializes(IS_SACK)) play.isSack = Helpers::booleanResult(number(IS_SACK));
+    if (config.materializes(IS_INTERCEPTION)) play.isInterception = Helpers::booleanResult(number(IS_INTERCEPTION));
+    if (config.materializes(IS_FUMBLE)) play.isFumble = Helpers::booleanResult(number(IS_FUMBLE));
+    if (config.materializes(IS_TWO_POINT_CONVERSION)) {
+        play.isTwoPointConversion = Helpers::booleanResult(number(IS_TWO_POINT_CONVERSION));
+    }
+    if (config.materializes(IS_TWO_POINT_CONVERSION_SUCCESSFUL)) {
+        play.isTwoPointConversionSuccessful = Helpers::booleanResult(number(IS_TWO_POINT_CONVERSION_SUCCESSFUL));
+    }
+    if (config.materializes(RUSH_DIRECTION)) play.rushDirection = text(RUSH_DIRECTION);
+
+    //weights of favorable outcomes, combined into the rating of the play
+    play.firstDownWeight = play.resultIsFirstDown ? 10.0f : 0.0f;
+    play.yardsWeight = Helpers::calculateWeight(play.resultingYards);
+    play.touchdownWeight = play.isTouchdown ? 10.0f : 0.0f;
+    play.interceptionWeight = play.isInterception ? -100.0f : 0.0f;
+    play.fumbleWeight = play.isFumble ? -1000.0f : 0.0f;
+    play.twoPointWeight = play.isTwoPointConversionSuccessful ? 5.0f : 0.0f;
+    play.rating = Helpers::calculateRating(play);
+    //read straight from the line, so the features are there even if the description itself isn't materialized
+    DescriptionFeatures::extract(string_view(fieldStarts[DESCRIPTION], fieldEnds[DESCRIPTION] - fieldStarts[DESCRIPTION]), play);
+    PlayDictionary::encodePlay(play);
+
+    //same successes SuccessTally::add counts
+    play.outcomes = 0;
+    if (play.resultIsFirstDown) play.outcomes |= FIRST_DOWN_OUTCOME;
+    if (play.isTouchdown) play.outcomes |= TOUCHDOWN_OUTCOME;
+    if (play.playType == "FIELD GOAL" && play.kickResult == KICK_GOOD) play.outcomes |= FIELD_GOAL_OUTCOME;
+    if (play.isTwoPointConversion && play.isTwoPointConversionSuccessful && play.playType != "EXTRA POINT") {
+        play.outcomes |= TWO_POINT_OUTCOME;
+    }
+
+    return true;
+}
+
+
+//the path itself if it is a file, or every .csv of a directory (like one file per season) in name order
+vector<string> PlayIngest::listDataFiles(const string& path) {
+    error_code err;
+    if (!filesystem::is_directory(path, err)) {
+        return {path};
+    }
+
+    vector<string> filenames;
+    for (const filesystem::directory_entry& entry : filesystem::directory_iterator(path, err)) {
+        if (entry.is_regular_file(err) && entry.path().extension() == ".csv") {
+            filenames.push_back(entry.path().string());
+        }
+    }
+    sort(filenames.begin(), filenames.end());
+    return filenames;
+}
+
+
+//reads the kept rows of a file into plays
+IngestStats PlayIngest::readFile(const string& filename, const IngestConfig& config, vector<Play>& plays) {
+    IngestStats stats;
+    ifstream file(filename);
+
+    if (!file.is_open()) {
+        cerr << "Could not open file: " << filename << endl;
+        return stats;
+    }
+    stats.filesRead++;
+
+    string line;
+    getline(file, line);
+    int i = 0;
+    int fileRow = 0;
+    size_t firstPlay = plays.size();
+
+    while (getline(file, line)) {
+        Play play;
+        play.fileRow = ++fileRow;
+        try {
+            //skips rows excluded by the ingest configuration before reading the rest of the line
+            if (!parseLine(line, config, play, stats)) {
+                continue;
+            }
+            i++;
+        }
+        //helps for debugging file
+        catch (exception& err) {
+            cout << "Error: " << err.what() << " at line " << i << " of " << filename << endl;
+        }
+
+        plays.push_back(std::move(play));
+    }
+    file.close();
+
+    //a punt's row has no distance, so it nets the yards to where the other team's next play of the game starts
+    for (size_t row = firstPlay; row + 1 < plays.size(); row++) {
+        const Play& next = plays[row + 1];
+        if (plays[row].isPunt && next.gameID == plays[row].gameID && next.offense != plays[row].offense) {
+            plays[row].resultingYards = (100 - next.yardLine) - plays[row].yardLine;
+        }
+    }
+
+    return stats;
+}
+
+
+//reads every file on the worker pool and appends their plays in file order
+//each file gets its own plays and stats, so the only shared state while reading is the dictionary
+IngestStats PlayIngest::readFiles(const vector<string>& filenames, const IngestConfig& config, vector<Play>& plays) {
+    int fileCount = static_cast<int>(filenames.size());
+    vector<vector<Play>> filePlays(fileCount);
+    vector<IngestStats> fileStats(fileCount);
+
+    WorkerPool::shared().parallelFor(fileCount, [&](int i) {
+        fileStats[i] = readFile(filenames[i], config, filePlays[i]);
+        for (Play& play : filePlays[i]) {
+            play.fileIndex = i;
+        }
+    });
+
+    IngestStats stats;
+    size_t totalPlays = plays.size();
+    for (int i = 0; i < fileCount; i++) {
+        stats.merge(fileStats[i]);
+        totalPlays += filePlays[i].size();
+    }
+
+    plays.reserve(totalPlays);
+    for (vector<Play>& readPlays : filePlays) {
+        move(readPlays.begin(), readPlays.end(), back_inserter(plays));
+    }
+
+    //ages are measured from the latest game so they don't change with the day the program is run
+    int latestDay = 0;
+    for (const Play& play : plays) {
+        latestDay = max(latestDay, play.gameDay);
+    }
+    for (Play& play : plays) {
+        play.ageInDays = play.gameDay == 0 ? 0 : latestDay - play.gameDay;
+    }
+    return stats;
+}
+
+
+//the heap takes over the parsed plays, so the hash table gets its copy of them first
+vector<Play> PlayIngest::takeHashTablePlays(vector<Play>& plays, bool heapUsesPlays) {
+    if (heapUsesPlays) {
+        return plays;
+    }
+    return std::move(plays);
+}
+
+
+//converts like stoi, ignoring leading whitespace and anything after the digits
+int PlayIngest::parseInt(const char* start, const char* end) {
+    while (start < end && isspace(static_cast<unsigned char>(*start))) {
+        start++;
+    }
+
+    bool isNegative = false;
+    if (start < end && (*start == '-' || *start == '+')) {
+        isNegative = *start == '-';
+        start++;
+    }
+
+    if (start == end || !isdigit(static_cast<unsigned char>(*start))) {
+        throw invalid_argument("stoi");
+    }
+
+    long value = 0;
+    while (start < end && isdigit(static_cast<unsigned char>(*start))) {
+        value = value*10 + (*start - '0');
+        if (value > 2147483647L + (isNegative ? 1 : 0)) {
+            throw out_of_range("stoi");
+        }
+        start++;
+    }
+    return static_cast<int>(isNegative ? -value : value);
+}
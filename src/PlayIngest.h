@@ -0,0 +1,78 @@
+#pragma once
+#include <string>
+#include <vector>
+
+
+#include "Play.h"
+
+
+using namespace std;
+
+
+//columns of the play-by-play .csv in file order
+enum PlayColumn {
+    GAME_ID, GAME_DATE, QUARTER, MINUTE, SECOND, OFFENSE, DEFENSE, DOWN, TO_GO, YARD_LINE,
+    IS_FIRST_DOWN, DESCRIPTION, YARDS, FORMATION, PLAY_TYPE, IS_RUSH, IS_PASS, IS_INCOMPLETE,
+    IS_TOUCHDOWN, PASS_TYPE, IS_SACK, IS_INTERCEPTION, IS_FUMBLE, IS_TWO_POINT_CONVERSION,
+    IS_TWO_POINT_CONVERSION_SUCCESSFUL, RUSH_DIRECTION, COLUMN_COUNT
+};
+
+
+//skips a row if the value of its column is one of the excluded values
+struct RowPredicate {
+    PlayColumn column;
+    vector<string> excludedValues;
+};
+
+
+//declares which columns get materialized into a Play and which rows are skipped while reading
+struct IngestConfig {
+    //bit i is set if column i gets materialized
+    unsigned int columns;
+    vector<RowPredicate> predicates;
+
+    bool materializes(PlayColumn column) const;
+
+    //every column, skipping the play types neither data structure suggests
+    static IngestConfig defaultConfig();
+
+    //the default configuration keeping punts, for the drive transitions and expected points drives end with
+    static IngestConfig withPunts();
+};
+
+
+//how many rows were read and skipped by each predicate value
+struct IngestStats {
+    int filesRead = 0;
+    long rowsRead = 0;
+    long rowsKept = 0;
+    //skippedRows[predicate][excluded value]
+    vector<vector<long>> skippedRows;
+
+    void merge(const IngestStats& other);
+
+    void print(const IngestConfig& config) const;
+};
+
+
+class PlayIngest {
+public:
+    //checks the predicate columns first and only splits the rest of the line if the row is kept
+    //returns false if the row is skipped, throws like stoi if a materialized number is malformed
+    static bool parseLine(const string& line, const IngestConfig& config, Play& play, IngestStats& stats);
+
+    //the path itself if it is a file, or every .csv of a directory (like one file per season) in name order
+    static vector<string> listDataFiles(const string& path);
+
+    //reads the kept rows of a file into plays
+    static IngestStats readFile(const string& filename, const IngestConfig& config, vector<Play>& plays);
+
+    //reads every file on the worker pool and appends their plays in file order
+    static IngestStats readFiles(const vector<string>& filenames, const IngestConfig& config, vector<Play>& plays);
+
+    //plays for the hash table from one parse, a copy if the heap takes over the parsed plays afterward or else the plays themselves
+    static vector<Play> takeHashTablePlays(vector<Play>& plays, bool heapUsesPlays);
+
+private:
+    static int parseInt(const char* start, const char* end);
+};
@@ -1,452 +1,500 @@
 #include <iostream>
 #include <fstream>
-#include <sstream>
-#include <queue>
 #include <map>
+#include <algorithm>
+#include <chrono>
 
 
 #include "Play.h"
 #include "ComparePlay.h"
+#include "SuccessTally.h"
 #include "Helpers.h"
 #include "PlayMaxHeap.h"
+#include "PlayIngest.h"
+#include "PlayDictionary.h"
+#include "ConfidenceIntervals.h"
 
 
 using namespace std;
 
-//read data from file and put into maxHeap
-void PlayMaxHeap::readDataAndPushIntoHeap(const string& filename, priority_queue<Play, vector<Play>, ComparePlay>& maxHeap) {
-    ifstream file(filename);
-
-    if (!file.is_open()) {
-        cerr << "Could not open file: " << filename << endl;
-        return;
-    }
-
-    string line;
-    getline(file, line);
-    int i = 0;
-
-    while (getline(file, line)) {
-        stringstream ss(line);
-        string token;
-
-        Play play;
-        try {
-            getline(ss, token, ',');  //read gameID
-            play.gameID = stoi(token);
-            getline(ss, token, ',');  //read gameDate
-            play.gameDate = token;
-            getline(ss, token, ',');  //read qtr
-            play.quarter = stoi(token);
-            getline(ss, token, ',');  //read minute
-            play.minutes = stoi(token);
-            getline(ss, token, ',');  //read second
-            play.seconds = stoi(token);
-            play.timeAsInt = Helpers::timeToInt(play.minutes, play.seconds);
-            getline(ss, token, ',');  //read offense
-            play.offense = token;
-            getline(ss, token, ',');  //read defense
-            play.defense = token;
-            getline(ss, token, ',');  //read down
-            play.down = stoi(token);
-            getline(ss, token, ',');  //read toGo
-            play.toGo = stoi(token);
-            getline(ss, token, ',');  //read yardLine
-            play.yardLine = stoi(token);
-            getline(ss, token, ',');  //read if result is first down
-            play.resultIsFirstDown = Helpers::booleanResult(stoi(token));
-            if (play.resultIsFirstDown) {
-                play.firstDownWeight = 10.0f;
-            }
-            getline(ss, token, ',');  //read description
-            play.description = token;
-            getline(ss, token, ',');  //read resultingYards
-            play.resultingYards = stoi(token);
-            play.yardsWeight = Helpers::calculateWeight(stoi(token));
-            getline(ss, token, ',');  //read formation
-            play.formation = token;
-            getline(ss, token, ',');  //read playType
-            play.playType = token;
-            getline(ss, token, ',');  //read if isRush
-            play.isRush = Helpers::booleanResult(stoi(token));
-            getline(ss, token, ',');  //read if isPass
-            play.isPass = Helpers::booleanResult(stoi(token));
-            getline(ss, token, ',');  //read if isComplete
-            play.isIncomplete = Helpers::booleanResult(stoi(token));
-            getline(ss, token, ',');  //read if isTouchdown
-            play.isTouchdown = Helpers::booleanResult(stoi(token));
-            if (play.isTouchdown) {
-                play.touchdownWeight = 10.0f;
-            }
-            getline(ss, token, ',');  //read passType
-            play.passType = token;
-            getline(ss, token, ',');  //read if isSack
-            play.isSack = Helpers::booleanResult(stoi(token));
-            getline(ss, token, ',');  //read if isInterception
-            play.isInterception = Helpers::booleanResult(stoi(token));
-            if (play.isInterception) {
-                play.interceptionWeight = -100.0f;
-            }
-            getline(ss, token, ',');  //read if isFumble
-            play.isFumble = Helpers::booleanResult(stoi(token));
-            if (play.isFumble) {
-                play.fumbleWeight = -1000.0f;
-            }
-            getline(ss, token, ',');  //read if isTwoPointConversion
-            play.isTwoPointConversion = Helpers::booleanResult(stoi(token));
-            getline(ss, token, ',');  //read if isTwoPointConversionSuccessful
-            play.isTwoPointConversionSuccessful = Helpers::booleanResult(stoi(token));
-            if (play.isTwoPointConversionSuccessful) {
-                play.twoPointWeight = 5.0f;
-            }
-            getline(ss, token, ',');  //read rushDirection
-            play.rushDirection = token;
-            i++;
-        }
-        //helps for debugging file
-        catch (exception& err) {
-            cout << "Error: " << err.what() << " at line " << i << endl;
-        }
+//read data from a single .csv or every .csv of a directory of seasons and put into maxHeap (stored as an array ordered by rating)
+IngestStats PlayMaxHeap::readDataAndPushIntoHeap(const string& path, PlayMaxHeap& maxHeap, const IngestConfig& config) {
+    //every file of a directory of seasons is read in parallel, then ordered all at once
+    vector<Play> plays;
+    IngestStats stats = PlayIngest::readFiles(PlayIngest::listDataFiles(path), config, plays);
+
+    maxHeap.build(plays);
+    return stats;
+}
 
-        //put into maxHeap
-        maxHeap.push(play);
+//bounds a query uses, the usual window or the adaptive one when a target sample is given
+AdaptiveWindow PlayMaxHeap::queryWindow(const Play& currentSituation, const PlayMaxHeap& maxHeap, const QueryOptions& options) {
+    if (options.targetSample > 0 && !maxHeap.counts.empty()) {
+        return maxHeap.counts.adapt(currentSituation, options.seasons, options.targetSample);
     }
-    file.close();
+
+    AdaptiveWindow window;
+    window.bounds = Helpers::calculateSituationBounds(currentSituation, options.seasons);
+    window.level = Helpers::DEFAULT_WINDOW_LEVEL;
+    window.count = -1;
+    window.targetSample = 0;
+    return window;
 }
 
+
 //gives result based on given current situation and all given situations for maxHeap
-void PlayMaxHeap::suggestPlayFromHeap(const Play& currentSituation, priority_queue<Play, vector<Play>, ComparePlay>& maxHeap) {
-    //copies it so that the heap can be reused multiple times each run
-    priority_queue<Play, vector<Play>, ComparePlay> modifiableHeap = maxHeap;
-    Play bestPlay = modifiableHeap.top();
-
-    //stores similar situations
-    priority_queue<Play, vector<Play>, ComparePlay> tempHeap;
-
-    //initialize bounds
-    int toGoLowerBound;
-    int toGoUpperBound;
-    int yardLineLowerBound;
-    int yardLineUpperBound;
-
-    //handles if it is not determining a 2 point conversion
-    if (currentSituation.down != 0) {
-        //bounds for toGo have 1 yard leeway
-        toGoLowerBound = Helpers::calculateToGoBounds(currentSituation.toGo)[0];
-        toGoUpperBound = Helpers::calculateToGoBounds(currentSituation.toGo)[1];
-
-        //bounds for yardLine have 5 yard leeway
-        yardLineLowerBound = Helpers::calculateYardLineBounds(currentSituation.yardLine)[0];
-        yardLineUpperBound = Helpers::calculateYardLineBounds(currentSituation.yardLine)[1];
-    }
-    //if it is determining a 2 point conversion
-    else {
-        toGoLowerBound = 0;
-        toGoUpperBound = 0;
-        yardLineLowerBound = 98;
-        yardLineUpperBound = 99;
-    }
-
-    //bounds for time always have 1:30 leeway
-    int timeLowerBound = Helpers::calculateTimeBounds(currentSituation.minutes, currentSituation.seconds)[0];
-    int timeUpperBound = Helpers::calculateTimeBounds(currentSituation.minutes, currentSituation.seconds)[1];
-
-    //initialize counters
-    int firstDowns = 0;
-    int touchdowns = 0;
-    int conversions = 0;
-    int fieldGoals = 0;
-    int firstDownPasses = 0;
-    int firstDownRushes = 0;
-    int touchdownPasses = 0;
-    int touchdownRushes = 0;
-    int twoPointPasses = 0;
-    int twoPointRushes = 0;
-
-    //map<playType, map<subPlayType, numOfSuccesses>>
-    map<string, map<string,int>> playTypeSuccessMap = {};
-
-    while (!modifiableHeap.empty()) {
-        Play currentPlay = modifiableHeap.top();
-
-        modifiableHeap.pop();
-
-        //checks if quarter and down are same, toGo is within 1 yard inclusive
-        //yardLine is within 5 yards inclusive, and time is within 1:30 inclusive
-        //then adds current iteration of play into tempHeap if all are true
-        if (currentPlay.quarter == currentSituation.quarter && currentPlay.down == currentSituation.down
-            && currentPlay.toGo >= toGoLowerBound && currentPlay.toGo <= toGoUpperBound
-            && currentPlay.yardLine >= yardLineLowerBound && currentPlay.yardLine <= yardLineUpperBound
-            && currentPlay.timeAsInt >= timeLowerBound && currentPlay.timeAsInt <= timeUpperBound) {
-
-            tempHeap.push(currentPlay);
-
-            //if it's determining a two point conversion
-            if (currentSituation.isTwoPointConversion && currentPlay.isTwoPointConversion && currentPlay.playType != "EXTRA POINT") {
-
-                //calculating likelihood of successful conversion in situation
-                if (currentPlay.isTwoPointConversionSuccessful) {
-                    conversions++;
-                    //from https://stackoverflow.com/questions/2340281/check-if-a-string-contains-a-string-in-c
-                    //uses this because .csv doesn't specify if pass or rush directly if it's a conversion
-                    if (currentPlay.description.find("PASS") != string::npos) {
-                        twoPointPasses++;
-                        playTypeSuccessMap[currentPlay.playType]["PASS"]++;  //for specific formation
-                    }
-                    else if (currentPlay.description.find("RUSH") != string::npos) {
-                        twoPointRushes++;
-                        playTypeSuccessMap[currentPlay.playType]["RUSH"]++;  //for specific formation
-                    }
-                }
+vector<int> PlayMaxHeap::suggestPlayFromHeap(const Play& currentSituation, const PlayMaxHeap& maxHeap, const QueryOptions& options) {
+    //stores similar situations along with a dense array of their ratings for finding the best play
+    vector<const Play*> matches;
+    vector<int> matchRows;
+    vector<int> matchRatings;
+
+    //toGo has 1 yard leeway, yardLine has 5 yards leeway, and time has 1:30 leeway unless the window is adaptive
+    AdaptiveWindow window = queryWindow(currentSituation, maxHeap, options);
+    SituationBounds bounds = window.bounds;
+    if (options.targetSample > 0) {
+        window.print();
+    }
+
+    //counts outcomes of similar situations
+    SuccessTally tally;
+
+    //custom weights rate only the similar situations, the heap stays ordered by the ratings from ingest
+    bool customWeights = !options.weights.isDefault();
+
+    //checks the packed situation words instead of the plays, so only similar situations are ever read
+    const vector<uint64_t>& words = maxHeap.packed.getWords();
+    uint64_t lower = 0;
+    uint64_t upper = 0;
+    bool anyMatch = PackedSituations::packBounds(bounds, lower, upper);
+
+    //adds a play into matches, visit also checks that it is within the bounds of the current situation first
+    auto take = [&](int index) {
+        const Play& currentPlay = maxHeap.at(index);
+        matches.push_back(&currentPlay);
+        matchRows.push_back(index);
+        matchRatings.push_back(customWeights ? options.weights.rating(currentPlay) : currentPlay.rating);
+
+        tally.add(currentPlay, currentSituation.isTwoPointConversion);
+    };
+    auto visit = [&](int index) {
+        if (PackedSituations::matches(words[index], lower, upper)) {
+            take(index);
+        }
+    };
+
+    //scans the heap in place so it can be reused multiple times each run without copying
+    //only the smallest of the clustered runs, the team partition or the overlapping seasons is scanned
+    const vector<int>* partition = maxHeap.teamPartition(bounds);
+    vector<const SeasonPartition*> seasons;
+    long seasonRows = maxHeap.size();
+    if (bounds.hasSeasonFilter()) {
+        seasons = maxHeap.seasonPartitions(bounds);
+        seasonRows = 0;
+        for (const SeasonPartition* season : seasons) {
+            seasonRows += static_cast<long>(season->rows.size());
+        }
+    }
+    long partitionRows = partition != nullptr ? static_cast<long>(partition->size()) : maxHeap.size();
+    long bytesTouched = 0;
+    vector<SituationRun> runs;
+    if (anyMatch) {
+        runs = maxHeap.clustered.runs(lower, upper, bytesTouched);
+    }
+    long scannedRows = 0;
+    string scanned;
+
+    //nothing is scanned for a team that isn't in the data
+    if (!anyMatch) {
+        partition = nullptr;
+        seasons.clear();
+        scanned = "nothing";
+    }
+    //keywords are intersected with whichever is smaller, the plays using every word or the clustered runs of the situation
+    else if (!options.keywords.empty() && !maxHeap.textIndex.empty()) {
+        auto start = chrono::steady_clock::now();
+        vector<int> rows = maxHeap.textIndex.matchingRows(options.keywords);
+        bytesTouched += static_cast<long>(rows.size() * sizeof(int));
+        if (ClusteredSituations::runRows(runs) < static_cast<long>(rows.size())) {
+            ClusteredScan scan = maxHeap.clustered.scan(runs, lower, upper);
+            vector<int> both;
+            set_intersection(scan.rows.begin(), scan.rows.end(), rows.begin(), rows.end(), back_inserter(both));
+            for (int index : both) {
+                take(index);
             }
-            //if it's not determining a two point conversion
-            else {
-                if (currentSituation.isTwoPointConversion && currentPlay.playType == "PASS") {
-                    cout << currentPlay.playType << ": " << currentPlay.description << endl;
-                }
-
-                //calculating likelihood of first down in situation
-                if (currentPlay.resultIsFirstDown) {
-                    firstDowns++;
-                    if (currentPlay.isPass) {
-                        firstDownPasses++;
-                        playTypeSuccessMap[currentPlay.playType][currentPlay.passType]++;  //for specific pass type
-                    }
-                    else if (currentPlay.isRush) {
-                        firstDownRushes++;
-                        playTypeSuccessMap[currentPlay.playType][currentPlay.rushDirection]++;  //for specific rush dir
-                    }
-                }
-
-                //calculating likelihood of TD in situation
-                if (currentPlay.isTouchdown) {
-                    touchdowns++;
-                    if (currentPlay.isPass) {
-                        touchdownPasses++;
-                        playTypeSuccessMap[currentPlay.playType][currentPlay.passType]++;  //for specific pass type
-                    } else if (currentPlay.isRush) {
-                        touchdownRushes++;
-                        playTypeSuccessMap[currentPlay.playType][currentPlay.rushDirection]++;  //for specific rush dir
-                    }
-                }
-
-                //calculating likelihood of successful field goal in situation
-                if (currentPlay.playType == "FIELD GOAL") {
-                    //from https://stackoverflow.com/questions/2340281/check-if-a-string-contains-a-string-in-c
-                    //uses this because .csv file doesn't directly specify if field goal is good or not
-                    if (currentPlay.description.find("IS GOOD") != string::npos) {
-                        fieldGoals++;
-                        playTypeSuccessMap[currentPlay.playType][currentPlay.formation]++; //for specific formation
-                    }
-                }
+            scannedRows = scan.scannedRows;
+            bytesTouched += scan.bytesTouched;
+        }
+        else {
+            for (int index : rows) {
+                visit(index);
             }
+            scannedRows = static_cast<long>(rows.size());
+            bytesTouched += scannedRows * static_cast<long>(sizeof(uint64_t));
         }
+        double micros = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+        scanned = "the text index and situation in " + to_string(static_cast<int>(micros)) + " us";
+    }
+    else if (ClusteredSituations::runRows(runs) <= min(partitionRows, seasonRows)) {
+        ClusteredScan scan = maxHeap.clustered.scan(runs, lower, upper);
+        for (int index : scan.rows) {
+            take(index);
+        }
+        scannedRows = scan.scannedRows;
+        bytesTouched += scan.bytesTouched;
+        scanned = to_string(scan.runs) + (scan.runs == 1 ? " run" : " runs") + " of the clustered layout";
+    }
+    else if (partition != nullptr && partitionRows <= seasonRows) {
+        for (int index : *partition) {
+            visit(index);
+        }
+        scannedRows = partitionRows;
+        scanned = "the team partition";
+        //partitions read an index and a word per row
+        bytesTouched += scannedRows * static_cast<long>(sizeof(int) + sizeof(uint64_t));
+    }
+    else if (bounds.hasSeasonFilter()) {
+        //rows of a season are in heap order, so matches stay in the same order as a full scan within a season
+        for (const SeasonPartition* season : seasons) {
+            for (int index : season->rows) {
+                visit(index);
+            }
+        }
+        scannedRows = seasonRows;
+        scanned = "the season partitions";
+        bytesTouched += scannedRows * static_cast<long>(sizeof(int) + sizeof(uint64_t));
+    }
+    else {
+        for (int index = 0; index < maxHeap.size(); index++) {
+            visit(index);
+        }
+        scannedRows = maxHeap.size();
+        scanned = "every play";
+        bytesTouched += scannedRows * static_cast<long>(sizeof(uint64_t));
+    }
+    if (options.showStats) {
+        cout << "Scanned " << scannedRows << " rows of " << scanned << ", " << bytesTouched << " bytes touched instead of "
+             << maxHeap.size() * static_cast<long>(sizeof(uint64_t)) << " for every play\n";
     }
 
     //if there are no similar situations within bounds given
-    if (tempHeap.empty()) {
+    if (matches.empty()) {
+        if (options.nearestNeighbors > 0 && !maxHeap.getNeighbors().empty()) {
+            cout << "No Match Found! Using the most similar situations instead.\n";
+            SituationKdTree::printNeighbors(currentSituation,
+                                            maxHeap.getNeighbors().nearest(currentSituation, bounds, options.nearestNeighbors));
+            return {};
+        }
         cout << "No Match Found! Good Luck!\n\n";
-        return;
+        return {};
     }
+    //the best play is the highest rating among the similar situations
+    const Play& bestPlay = *matches[Helpers::bestRatedIndex(matchRatings, matches)];
+
     //if there is a similar situation but the attempt was unsuccessful
-    if (tempHeap.top().isIncomplete || tempHeap.top().isInterception || tempHeap.top().resultingYards < 0) {
-        if (tempHeap.size() > 1) {
-            cout << "Matches found, but with no gain. Here are their game IDs:\n";
-            for (int i = 0; i < tempHeap.size(); i++) {
-                cout << tempHeap.top().gameID << endl;
-                tempHeap.pop();
-            }
+    //the game IDs are listed afterward as pages of top historical plays
+    if (bestPlay.isIncomplete || bestPlay.isInterception || bestPlay.resultingYards < 0) {
+        if (matches.size() > 1) {
+            cout << "Matches found, but with no gain.\n";
         }
         else {
-            cout << "Match found, but with no gain. Here is its game ID:\n";
-            cout << tempHeap.top().gameID << endl;
+            cout << "Match found, but with no gain.\n";
         }
         cout << endl;
-        return;
-    }
-
-    //the best play is at the top of the max Heap depending on rating given by ComparePlay
-    bestPlay = tempHeap.top();
-
-    map<string, float> likelihoods;
-
-    //likelihoods for first downs
-    float likelihoodFirstDown = (static_cast<float>(firstDowns)/static_cast<float>(tempHeap.size()))*100;
-    //puts likelihood of first down into map that's unsorted by likelihood
-    likelihoods["First Down: "] = likelihoodFirstDown;
-    float likelihoodFirstDownPass = 0;
-    float likelihoodFirstDownRush = 0;
-    //so that it doesn't divide by 0
-    if (firstDowns != 0) {
-        likelihoodFirstDownPass = (static_cast<float>(firstDownPasses)/static_cast<float>(firstDowns))*100;
-        likelihoodFirstDownRush = (static_cast<float>(firstDownRushes)/static_cast<float>(firstDowns))*100;
-    }
-
-    //likelihoods for touchdowns
-    float likelihoodTouchdown = (static_cast<float>(touchdowns)/static_cast<float>(tempHeap.size()))*100;
-    //puts likelihood of touchdown into map that's unsorted by likelihood
-    likelihoods["Touchdown: "] = likelihoodTouchdown;
-    float likelihoodTouchdownPass = 0;
-    float likelihoodTouchdownRush = 0;
-    //so that it doesn't divide by 0
-    if (touchdowns != 0) {
-        likelihoodTouchdownPass = (static_cast<float>(touchdownPasses)/static_cast<float>(touchdowns))*100;
-        likelihoodTouchdownRush = (static_cast<float>(touchdownRushes)/static_cast<float>(touchdowns))*100;
-    }
-
-    //likelihoods for conversions
-    float likelihoodTwoPoint = (static_cast<float>(conversions)/static_cast<float>(tempHeap.size()))*100;
-    //likelihood of conversion not into map because if calculating for conversion, will be the only one printed
-    //...so it will not need to be sorted
-    float likelihoodTwoPointPass = 0;
-    float likelihoodTwoPointRush = 0;
-    //so that it doesn't divide by 0
-    if (conversions != 0) {
-        likelihoodTwoPointPass = (static_cast<float>(twoPointPasses)/static_cast<float>(conversions))*100;
-        likelihoodTwoPointRush = (static_cast<float>(twoPointRushes)/static_cast<float>(conversions))*100;
-    }
-
-    //likelihood for field goals
-    float likelihoodFieldGoal = 0.0f;
-    //so that it doesn't divide by 0
-    if (fieldGoals != 0) {
-        likelihoodFieldGoal = (static_cast<float>(fieldGoals)/static_cast<float>(tempHeap.size()))*100;
-    }
-    //puts likelihood of field goal into map that's unsorted by likelihood
-    likelihoods["Field Goal: "] = likelihoodFieldGoal;
-
-
-    //logic for multimap inspired by https://www.educative.io/answers/how-to-sort-a-map-by-value-in-cpp
-    //is so that the likelihoods map can be sorted by value
-    //logic of descending sorted map from https://www.geeksforgeeks.org/descending-order-map-multimap-c-stl/
-    multimap<float, string, greater<float>> sortedLikelihoods;
-    //will sort the likelihoods map by the key's value
-    for (auto iter = likelihoods.begin(); iter != likelihoods.end(); iter++) {
-        sortedLikelihoods.insert({iter->second, iter->first});
-    }
-
-    int mostSuccesses = -1;
-    //map<amtOfSuccess, map<playType, subPlayType>>
-    //logic of descending sorted map from https://www.geeksforgeeks.org/descending-order-map-multimap-c-stl/
-    map<int, pair<string, string>, greater<int>> successfulPlayMap = {};
-
-    //puts successful play(s) into separate map
-    //keeps 1 if it has the most successes and keeps multiple if successes are the same for 2 different plays
-    for (auto iter = playTypeSuccessMap.begin(); iter != playTypeSuccessMap.end(); iter++) {
-        for (auto iter2 = iter->second.begin(); iter2 != iter->second.end(); iter2++) {
-            if (iter2->second > mostSuccesses) {
-                successfulPlayMap[iter2->second] = {iter->first, iter2->first};
-                mostSuccesses = iter2->second;
-            }
-        }
+        return matchRows;
     }
 
-    cout << "\nOUT OF " << tempHeap.size() << " SIMILAR SITUATIONS, ";
-    //if plural amount of successful plays
-    if (successfulPlayMap.size() > 1) {
-        cout << "THE IDEAL PLAYS' LIKELIHOODS ARE:\n";
+    //recent seasons count more when a half-life is given
+    WeightedRates weighted;
+    if (options.halfLifeSeasons > 0) {
+        weighted = RecencyWeighting::compute(matches, options.halfLifeSeasons);
     }
-    else {
-        cout << "THE IDEAL PLAY'S LIKELIHOOD IS:\n";
+    LikelihoodIntervals intervals;
+    if (options.confidenceIntervals) {
+        intervals = ConfidenceIntervals::compute(matches, tally, currentSituation.isTwoPointConversion, options.latencyBudgetMs);
     }
+    tally.printSuggestion(currentSituation, bestPlay, options.halfLifeSeasons > 0 ? &weighted : nullptr,
+                          options.confidenceIntervals ? &intervals : nullptr);
 
+    return matchRows;
+}
 
-    //prints ideal plays in descending order by iterating through map of occurrences with their respective plays
-    for (auto iter = successfulPlayMap.begin(); iter != successfulPlayMap.end(); iter++) {
-        float subPlayLikelihood = (static_cast<float>(iter->first)/static_cast<float>(tempHeap.size()))*100;
-        if (iter->second.first == "FIELD GOAL") {
-            cout << "    " << iter->second.first << " IN " << iter->second.second << " FORMATION: ";
-        }
-        else {
-            cout << "    " << iter->second.first << " " << iter->second.second << ": ";
+
+//takes over the given plays and orders them into a heap with a radix sort on their ratings
+//a descending array already satisfies the max heap property, so no comparisons are needed
+void PlayMaxHeap::build(vector<Play>& newPlays) {
+    plays = std::move(newPlays);
+    Helpers::radixSortByRating(plays);
+    buildPartitions();
+    //the tree points into the old plays, so it is rebuilt if it was in use
+    if (!neighbors.empty()) {
+        indexNeighbors();
+    }
+    if (!counts.empty()) {
+        indexCounts();
+    }
+    if (!textIndex.empty()) {
+        indexText();
+    }
+}
+
+
+//partitions the heap indices by offense and defense team code and by season, and packs the situation columns
+void PlayMaxHeap::buildPartitions() {
+    offenseRows.assign(PlayDictionary::MAX_TEAMS, {});
+    defenseRows.assign(PlayDictionary::MAX_TEAMS, {});
+    seasons.clear();
+
+    //map<season, index of partition in seasons>
+    map<int, int> seasonIndices;
+    for (int i = 0; i < static_cast<int>(plays.size()); i++) {
+        offenseRows[plays[i].offenseCode].push_back(i);
+        defenseRows[plays[i].defenseCode].push_back(i);
+
+        auto found = seasonIndices.find(plays[i].season);
+        if (found == seasonIndices.end()) {
+            found = seasonIndices.insert({plays[i].season, static_cast<int>(seasons.size())}).first;
+            seasons.emplace_back();
+            seasons.back().season = plays[i].season;
         }
-        cout << Helpers::formatPercentages(subPlayLikelihood) << "%\n";
+        seasons[found->second].add(plays[i], i);
     }
+    packed.build(plays);
+    clustered.build(packed);
 
-    cout << "\nLIKELIHOODS:\n";
+    sort(seasons.begin(), seasons.end(), [](const SeasonPartition& a, const SeasonPartition& b) {
+        return a.season < b.season;
+    });
+}
 
-    //only prints 2 pt conversion if the inputted situation prompted for 2 pt conversion likelihood
-    if (currentSituation.isTwoPointConversion) {
-        cout << "    Two Point Conversion: " << Helpers::formatPercentages(likelihoodTwoPoint) << "%\n";
-        cout << "        Two Point Pass: " << Helpers::formatPercentages(likelihoodTwoPointPass) << "%\n";
-        cout << "        Two Point Rush: " << Helpers::formatPercentages(likelihoodTwoPointRush) << "%\n";
+
+void SeasonPartition::add(const Play& play, int index) {
+    if (rows.empty()) {
+        minQuarter = maxQuarter = play.quarter;
+        minDown = maxDown = play.down;
+        minToGo = maxToGo = play.toGo;
+        minYardLine = maxYardLine = play.yardLine;
+        minTime = maxTime = play.timeAsInt;
+        minDate = maxDate = play.dateAsInt;
     }
-    else {
-        //orders from greatest to least likelihoods in printing
-        for (auto iter = sortedLikelihoods.begin(); iter != sortedLikelihoods.end(); iter++) {
-            //ignores likelihoods of 0%
-            if (iter->first != 0) {
-                cout << "    " << iter->second << Helpers::formatPercentages(iter->first) << "%\n";
-                //if it's a first down
-                if (iter->second.find("Fir") != string::npos) {
-                    cout << "        Passing: " << Helpers::formatPercentages(likelihoodFirstDownPass) << "%\n";
-                    cout << "        Rushing: " << Helpers::formatPercentages(likelihoodFirstDownRush) << "%\n";
-                }
-                //if it's a touchdown
-                else if (iter->second.find("To") != string::npos){
-                    cout << "        Passing: " << Helpers::formatPercentages(likelihoodTouchdownPass) << "%\n";
-                    cout << "        Rushing: " << Helpers::formatPercentages(likelihoodTouchdownRush) << "%\n";
-                }
-            }
+    rows.push_back(index);
+
+    minQuarter = min(minQuarter, play.quarter);
+    maxQuarter = max(maxQuarter, play.quarter);
+    minDown = min(minDown, play.down);
+    maxDown = max(maxDown, play.down);
+    minToGo = min(minToGo, play.toGo);
+    maxToGo = max(maxToGo, play.toGo);
+    minYardLine = min(minYardLine, play.yardLine);
+    maxYardLine = max(maxYardLine, play.yardLine);
+    minTime = min(minTime, play.timeAsInt);
+    maxTime = max(maxTime, play.timeAsInt);
+    minDate = min(minDate, play.dateAsInt);
+    maxDate = max(maxDate, play.dateAsInt);
+}
+
+
+//checks if the season is in the range and its plays could be within the bounds
+bool SeasonPartition::overlaps(const SituationBounds& bounds) const {
+    return season >= bounds.firstSeason && season <= bounds.lastSeason
+           && minQuarter <= bounds.quarter && maxQuarter >= bounds.quarter
+           && minDown <= bounds.down && maxDown >= bounds.down
+           && minToGo <= bounds.toGoUpperBound && maxToGo >= bounds.toGoLowerBound
+           && minYardLine <= bounds.yardLineUpperBound && maxYardLine >= bounds.yardLineLowerBound
+           && minTime <= bounds.timeUpperBound && maxTime >= bounds.timeLowerBound;
+}
+
+
+const Play& PlayMaxHeap::top() const {
+    return plays.front();
+}
+
+
+const Play& PlayMaxHeap::at(int index) const {
+    return plays[index];
+}
+
+
+const vector<Play>& PlayMaxHeap::getPlays() const {
+    return plays;
+}
+
+
+const PackedSituations& PlayMaxHeap::getPacked() const {
+    return packed;
+}
+
+
+const ClusteredSituations& PlayMaxHeap::getClustered() const {
+    return clustered;
+}
+
+
+const vector<int>* PlayMaxHeap::teamPartition(const SituationBounds& bounds) const {
+    static const vector<int> NO_PLAYS;
+    if (bounds.offenseCode == SituationBounds::UNKNOWN_TEAM || bounds.defenseCode == SituationBounds::UNKNOWN_TEAM) {
+        return &NO_PLAYS;
+    }
+
+    const vector<int>* partition = nullptr;
+    if (bounds.offenseCode != SituationBounds::ANY_TEAM) {
+        partition = &offenseRows[bounds.offenseCode];
+    }
+    if (bounds.defenseCode != SituationBounds::ANY_TEAM
+        && (partition == nullptr || defenseRows[bounds.defenseCode].size() < partition->size())) {
+        partition = &defenseRows[bounds.defenseCode];
+    }
+    return partition;
+}
+
+
+vector<const SeasonPartition*> PlayMaxHeap::seasonPartitions(const SituationBounds& bounds) const {
+    vector<const SeasonPartition*> overlapping;
+    for (const SeasonPartition& season : seasons) {
+        if (season.overlaps(bounds)) {
+            overlapping.push_back(&season);
         }
     }
+    return overlapping;
+}
+
+
+const vector<SeasonPartition>& PlayMaxHeap::getSeasons() const {
+    return seasons;
+}
+
+
+void PlayMaxHeap::indexNeighbors() {
+    neighbors.build(playPointers());
+}
+
+
+const SituationKdTree& PlayMaxHeap::getNeighbors() const {
+    return neighbors;
+}
+
+
+void PlayMaxHeap::indexCounts() {
+    counts.build(playPointers());
+}
+
+
+void PlayMaxHeap::indexText() {
+    textIndex.build(plays);
+}
+
+
+const DescriptionIndex& PlayMaxHeap::getTextIndex() const {
+    return textIndex;
+}
 
-    cout << "\nBEST HISTORICAL PLAY: " << bestPlay.playType;
-    if (bestPlay.isPass) {
-        cout << " " << bestPlay.passType;
+
+//points to every play in heap order, for the indexes built over all plays
+vector<const Play*> PlayMaxHeap::playPointers() const {
+    vector<const Play*> pointers;
+    pointers.reserve(plays.size());
+    for (const Play& play : plays) {
+        pointers.push_back(&play);
     }
-    else if (bestPlay.isRush) {
-        cout << " " << bestPlay.rushDirection;
+    return pointers;
+}
+
+
+MemoryReport PlayMaxHeap::memoryUsage() const {
+    MemoryReport report;
+    report.title = "Heap memory";
+
+    long playBytes = static_cast<long>((plays.capacity() - plays.size()) * sizeof(Play));
+    for (const Play& play : plays) {
+        playBytes += MemoryAccounting::playBytes(play);
     }
+    report.add("plays", playBytes);
 
-    //if best play starts with a vowel
-    if (bestPlay.formation[0] == 'A' || bestPlay.formation[0] == 'E' || bestPlay.formation[0] == 'I'
-        || bestPlay.formation[0] == 'O' || bestPlay.formation[0] == 'U') {
-        cout << " with an " << bestPlay.formation << " formation\n";
+    long partitionBytes = static_cast<long>((offenseRows.capacity() + defenseRows.capacity()) * sizeof(vector<int>)
+                                            + seasons.capacity() * sizeof(SeasonPartition));
+    for (int code = 0; code < static_cast<int>(offenseRows.size()); code++) {
+        partitionBytes += static_cast<long>((offenseRows[code].capacity() + defenseRows[code].capacity()) * sizeof(int));
     }
-    else {
-        cout << " with a " << bestPlay.formation << " formation\n";
+    for (const SeasonPartition& season : seasons) {
+        partitionBytes += static_cast<long>(season.rows.capacity() * sizeof(int));
     }
+    report.add("team and season partitions", partitionBytes);
+    report.add("packed situations", packed.memoryBytes());
+    report.add("clustered situations", clustered.memoryBytes());
+    report.add("nearest neighbour tree", neighbors.memoryBytes());
+    report.add("window counts", counts.memoryBytes());
+    report.add("text index", textIndex.memoryBytes());
+    return report;
+}
 
-    //formatted output in paragraph form prints
-    cout << "    On " << bestPlay.gameDate << ", " << bestPlay.offense;
-    if (bestPlay.isTwoPointConversion && bestPlay.isTwoPointConversionSuccessful) {
-        cout << " scored 2 points ";
-        cout << "against " << bestPlay.defense << " during quarter " << bestPlay.quarter;
-        cout << " at time " << Helpers::formatTime(bestPlay.minutes, bestPlay.seconds) << ".\n";
+
+long PlayMaxHeap::evictColdFields() {
+    long freed = 0;
+    for (Play& play : plays) {
+        freed += MemoryAccounting::evictColdFields(play);
     }
-    else {
-        cout << " gained " << bestPlay.resultingYards << " yards ";
-        cout << "against " << bestPlay.defense << " during quarter " << bestPlay.quarter << " on down " << bestPlay.down;
-        cout << " on the " << bestPlay.yardLine << " yard line with " << bestPlay.toGo << " yards to go at time ";
-        cout << Helpers::formatTime(bestPlay.minutes, bestPlay.seconds) << ".\n";
-    }
-    cout << "The play ";
-    if (bestPlay.isTwoPointConversion) {
-        cout << "was a Two Point Conversion and was";
-        if (bestPlay.isTwoPointConversionSuccessful) {
-            cout << " ";
+    return freed;
+}
+
+
+int PlayMaxHeap::size() const {
+    return static_cast<int>(plays.size());
+}
+
+
+bool PlayMaxHeap::empty() const {
+    return plays.empty();
+}
+
+
+HeapTopWalk::HeapTopWalk(const PlayMaxHeap& heap, vector<int> matchedRows, const ScoringWeights& weights)
+    : heap(heap), ranked(std::move(matchedRows)) {
+    //the season partitions are scanned one after another, so the matches are only sorted within each season
+    sort(ranked.begin(), ranked.end());
+    if (!weights.isDefault()) {
+        vector<pair<int, int>> rated;
+        rated.reserve(ranked.size());
+        for (int index : ranked) {
+            rated.push_back({weights.rating(heap.at(index)), index});
         }
-        else {
-            cout << "not ";
+        stable_sort(rated.begin(), rated.end(), [](const pair<int, int>& a, const pair<int, int>& b) {
+            return a.first > b.first;
+        });
+        for (int i = 0; i < static_cast<int>(rated.size()); i++) {
+            ranked[i] = rated[i].second;
         }
-        cout << "successful.";
     }
-    else {
-        if (bestPlay.isTouchdown) {
-            cout << "resulted in a touchdown.";
+}
+
+
+vector<const Play*> HeapTopWalk::next(int count) {
+    vector<const Play*> page;
+    while (nextRanked < static_cast<int>(ranked.size()) && static_cast<int>(page.size()) < count) {
+        page.push_back(&heap.at(ranked[nextRanked++]));
+    }
+    return page;
+}
+
+
+bool HeapTopWalk::done() const {
+    return nextRanked >= static_cast<int>(ranked.size());
+}
+
+
+//prints a page of plays starting at the given rank, returns the rank of the next page
+int HeapTopWalk::printPage(const vector<const Play*>& page, int firstRank) {
+    int rank = firstRank;
+    for (const Play* play : page) {
+        cout << "    " << rank << ". " << play->playType;
+        if (play->isPass) {
+            cout << " " << play->passType;
         }
-        else {
-            cout << "did not result in a touchdown";
-            if (bestPlay.resultIsFirstDown) {
-                cout << ", but it did result in a first down.";
-            }
-            else {
-                cout << " or a first down.";
-            }
+        else if (play->isRush) {
+            cout << " " << play->rushDirection;
         }
+        cout << " (" << play->resultingYards << " yards) on " << play->gameDate << ", " << play->offense;
+        cout << " against " << play->defense << " - Game ID: " << play->gameID << endl;
+        rank++;
     }
-    cout << "\nDescription: " << bestPlay.description << endl;
-    cout << "Game ID: " << bestPlay.gameID << endl << endl;
-    cout << "\n============================================= Welcome back to the Gridiron Guru! ============================================\n";
+    return rank;
 }
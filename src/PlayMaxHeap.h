@@ -1,14 +1,158 @@
+#pragma once
 #include <iostream>
+#include <vector>
+
+
+#include "Play.h"
+#include "Helpers.h"
+#include "PlayIngest.h"
+#include "SituationKdTree.h"
+#include "SituationCounts.h"
+#include "PackedSituations.h"
+#include "ClusteredSituations.h"
+#include "DescriptionIndex.h"
+#include "MemoryAccounting.h"
 
 
 using namespace std;
 
 
+//the heap indices of every play of one season along with the smallest and largest situation values
+//a query skips a whole season when its bounds can't overlap them
+struct SeasonPartition {
+    int season;
+    vector<int> rows;
+
+    int minQuarter;
+    int maxQuarter;
+    int minDown;
+    int maxDown;
+    int minToGo;
+    int maxToGo;
+    int minYardLine;
+    int maxYardLine;
+    int minTime;
+    int maxTime;
+    int minDate;
+    int maxDate;
+
+    void add(const Play& play, int index);
+
+    bool overlaps(const SituationBounds& bounds) const;
+};
+
+
 class PlayMaxHeap {
+private:
+    //plays in max heap order, the children of index i are at 2i+1 and 2i+2
+    vector<Play> plays;
+
+    //indices of each team's plays in heap order, indexed by team dictionary code
+    vector<vector<int>> offenseRows;
+    vector<vector<int>> defenseRows;
+
+    //partitions from earliest to latest season
+    vector<SeasonPartition> seasons;
+
+    //situation columns packed into one word per play, in heap order
+    PackedSituations packed;
+
+    //the packed words again, sorted by situation so a query reads a few contiguous runs
+    ClusteredSituations clustered;
+
+    //k-d tree over the plays, only built when nearest neighbour searches are used
+    SituationKdTree neighbors;
+
+    //counts used to pick the window, only built when a target sample is used
+    SituationCounts counts;
+
+    //words of the descriptions to the plays using them, only built when keyword queries are used
+    DescriptionIndex textIndex;
+
+    void buildPartitions();
+
 public:
-    //read data from file and put into heap
-    static void readDataAndPushIntoHeap(const string& filename, priority_queue<Play, vector<Play>, ComparePlay>& maxHeap);
+    //read data from a single .csv or every .csv of a directory of seasons and put into heap
+    static IngestStats readDataAndPushIntoHeap(const string& path, PlayMaxHeap& maxHeap,
+                                               const IngestConfig& config = IngestConfig::defaultConfig());
+
+    //bounds a query uses, the usual window or the adaptive one when a target sample is given
+    static AdaptiveWindow queryWindow(const Play& currentSituation, const PlayMaxHeap& maxHeap, const QueryOptions& options);
 
     //gives result based on given current situation and all given situations for maxHeap
-    static void suggestPlayFromHeap(const Play& currentSituation, priority_queue<Play, vector<Play>, ComparePlay>& maxHeap);
+    //returns the heap indices of the similar situations found, after the keywords filtered them
+    static vector<int> suggestPlayFromHeap(const Play& currentSituation, const PlayMaxHeap& maxHeap,
+                                   const QueryOptions& options = QueryOptions());
+
+    //takes over the given plays and orders them into a heap with a radix sort on their ratings
+    void build(vector<Play>& newPlays);
+
+    const Play& top() const;
+
+    const Play& at(int index) const;
+
+    //exposes the underlying heap array
+    const vector<Play>& getPlays() const;
+
+    const PackedSituations& getPacked() const;
+
+    const ClusteredSituations& getClustered() const;
+
+    //indices of the plays a query has to look at when it filters by team, nullptr when every play is needed
+    //uses the smaller of the offense and defense partitions so other teams are never visited
+    const vector<int>* teamPartition(const SituationBounds& bounds) const;
+
+    //seasons within the season range of the bounds whose plays could be similar situations
+    vector<const SeasonPartition*> seasonPartitions(const SituationBounds& bounds) const;
+
+    const vector<SeasonPartition>& getSeasons() const;
+
+    //builds the k-d tree used when no situation is within the bounds
+    void indexNeighbors();
+
+    const SituationKdTree& getNeighbors() const;
+
+    //builds the counts used to pick an adaptive window
+    void indexCounts();
+
+    //builds the index used to filter by description keywords
+    void indexText();
+
+    const DescriptionIndex& getTextIndex() const;
+
+    //points to every play in heap order, for the indexes built over all plays
+    vector<const Play*> playPointers() const;
+
+    //bytes held by the plays, partitions, packed words and indexes
+    MemoryReport memoryUsage() const;
+
+    //drops the fields no query reads from every play, returns the bytes freed
+    long evictColdFields();
+
+    int size() const;
+
+    bool empty() const;
+};
+
+
+//pages through the similar situations a heap query matched from best to worst without copying or modifying the heap
+//the heap array is sorted by rating, so the matches in index order are already ranked and a page of K costs O(K)
+class HeapTopWalk {
+private:
+    const PlayMaxHeap& heap;
+    //heap indices of the matches from best to worst
+    vector<int> ranked;
+    int nextRanked = 0;
+
+public:
+    //custom weights rank the matches by their custom rating instead, ties stay in index order like the best play
+    HeapTopWalk(const PlayMaxHeap& heap, vector<int> matchedRows, const ScoringWeights& weights = ScoringWeights());
+
+    //returns up to count of the next best matches
+    vector<const Play*> next(int count);
+
+    bool done() const;
+
+    //prints a page of plays starting at the given rank, returns the rank of the next page
+    static int printPage(const vector<const Play*>& page, int firstRank);
 };
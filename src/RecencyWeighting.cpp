@@ -0,0 +1,73 @@
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+
+
+#include "RecencyWeighting.h"
+
+
+using namespace std;
+
+
+//weights every match by 2^(-age/halfLife) and sums all four successes in a single pass
+//the matches are first gathered into dense arrays so the summing loop has no branches or pointers
+//weights are fixed-point integers so the sums don't depend on the order they are added in
+WeightedRates RecencyWeighting::compute(const vector<const Play*>& matches, float halfLifeSeasons) {
+    WeightedRates rates;
+    rates.halfLifeSeasons = halfLifeSeasons;
+    int count = static_cast<int>(matches.size());
+    if (count == 0 || halfLifeSeasons <= 0) {
+        return rates;
+    }
+
+    //gathers the columns the pass needs
+    vector<int> ages(count);
+    vector<uint8_t> outcomes(count);
+    int oldestAge = 0;
+    for (int i = 0; i < count; i++) {
+        ages[i] = matches[i]->ageInDays;
+        outcomes[i] = matches[i]->outcomes;
+        oldestAge = max(oldestAge, ages[i]);
+    }
+
+    //one weight per day of age, so the pass never calls exp2
+    const float daysPerSeason = 365.25f;
+    vector<int32_t> weightByAge(oldestAge + 1);
+    for (int age = 0; age <= oldestAge; age++) {
+        weightByAge[age] = static_cast<int32_t>(lround(WEIGHT_SCALE * exp2(-age / (halfLifeSeasons*daysPerSeason))));
+    }
+    vector<int32_t> weights(count);
+    for (int i = 0; i < count; i++) {
+        weights[i] = weightByAge[ages[i]];
+    }
+
+    //fused pass, each success adds the weight masked by its outcome bit
+    int64_t totalWeight = 0;
+    int64_t squaredWeight = 0;
+    int64_t firstDownWeight = 0;
+    int64_t touchdownWeight = 0;
+    int64_t fieldGoalWeight = 0;
+    int64_t twoPointWeight = 0;
+    for (int i = 0; i < count; i++) {
+        int64_t weight = weights[i];
+        int64_t outcome = outcomes[i];
+        totalWeight += weight;
+        squaredWeight += weight*weight;
+        firstDownWeight += weight & -(outcome & 1);
+        touchdownWeight += weight & -((outcome >> 1) & 1);
+        fieldGoalWeight += weight & -((outcome >> 2) & 1);
+        twoPointWeight += weight & -((outcome >> 3) & 1);
+    }
+
+    //every match so old that its weight rounds to 0
+    if (totalWeight == 0) {
+        return rates;
+    }
+    double total = static_cast<double>(totalWeight);
+    rates.firstDown = static_cast<float>(firstDownWeight/total*100);
+    rates.touchdown = static_cast<float>(touchdownWeight/total*100);
+    rates.fieldGoal = static_cast<float>(fieldGoalWeight/total*100);
+    rates.twoPoint = static_cast<float>(twoPointWeight/total*100);
+    rates.effectiveSituations = static_cast<float>(total*total/static_cast<double>(squaredWeight));
+    return rates;
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include <vector>
+
+
+#include "Play.h"
+
+
+using namespace std;
+
+
+//likelihoods of similar situations where recent seasons count more than older ones
+struct WeightedRates {
+    float halfLifeSeasons = 0.0f;
+    //percentages of the total weight
+    float firstDown = 0.0f;
+    float touchdown = 0.0f;
+    float fieldGoal = 0.0f;
+    float twoPoint = 0.0f;
+    //how many equally weighted situations the weights are worth, (sum of w)^2 / sum of w^2
+    float effectiveSituations = 0.0f;
+};
+
+
+class RecencyWeighting {
+public:
+    //fixed-point scale of the weight of a play from the latest game
+    static constexpr int WEIGHT_SCALE = 1 << 16;
+
+    //weights every match by 2^(-age/halfLife) and sums all four successes in a single pass
+    static WeightedRates compute(const vector<const Play*>& matches, float halfLifeSeasons);
+};
@@ -0,0 +1,186 @@
+#include <iostream>
+#include <algorithm>
+
+
+#include "SituationCounts.h"
+
+
+using namespace std;
+
+
+int SituationCounts::groupIndex(int quarter, int down) {
+    if (quarter < 0 || quarter >= QUARTERS || down < 0 || down >= DOWNS) {
+        return -1;
+    }
+    return quarter*DOWNS + down;
+}
+
+
+//lays out every group with a counting sort on its cells
+void SituationCounts::build(const vector<const Play*>& plays) {
+    groups.assign(QUARTERS*DOWNS, Group());
+
+    auto cellOf = [](const Play& play) {
+        int toGo = min(max(play.toGo, 0), TO_GO_VALUES - 1);
+        int yardLine = min(max(play.yardLine, 0), YARD_LINES - 1);
+        return toGo*YARD_LINES + yardLine;
+    };
+
+    for (const Play* play : plays) {
+        int group = groupIndex(play->quarter, play->down);
+        if (group == -1) {
+            continue;
+        }
+        if (groups[group].cellStarts.empty()) {
+            groups[group].cellStarts.assign(TO_GO_VALUES*YARD_LINES + 1, 0);
+        }
+        groups[group].cellStarts[cellOf(*play) + 1]++;
+    }
+
+    //prefix sums turn cell sizes into where each cell starts
+    vector<vector<int>> nextSlot(groups.size());
+    vector<vector<const Play*>> laidOut(groups.size());
+    for (int group = 0; group < static_cast<int>(groups.size()); group++) {
+        vector<int>& cellStarts = groups[group].cellStarts;
+        for (int cell = 1; cell < static_cast<int>(cellStarts.size()); cell++) {
+            cellStarts[cell] += cellStarts[cell - 1];
+        }
+        if (!cellStarts.empty()) {
+            laidOut[group].resize(cellStarts.back());
+            nextSlot[group] = cellStarts;
+        }
+    }
+
+    for (const Play* play : plays) {
+        int group = groupIndex(play->quarter, play->down);
+        if (group == -1) {
+            continue;
+        }
+        laidOut[group][nextSlot[group][cellOf(*play)]++] = play;
+    }
+
+    //the plays of each cell are sorted by time, then their columns are copied out in that order
+    for (int group = 0; group < static_cast<int>(groups.size()); group++) {
+        Group& counts = groups[group];
+        vector<const Play*>& cellPlays = laidOut[group];
+        for (int cell = 0; cell + 1 < static_cast<int>(counts.cellStarts.size()); cell++) {
+            sort(cellPlays.begin() + counts.cellStarts[cell], cellPlays.begin() + counts.cellStarts[cell + 1],
+                 [](const Play* a, const Play* b) {
+                return a->timeAsInt < b->timeAsInt;
+            });
+        }
+        counts.times.reserve(cellPlays.size());
+        counts.seasons.reserve(cellPlays.size());
+        counts.offenses.reserve(cellPlays.size());
+        counts.defenses.reserve(cellPlays.size());
+        for (const Play* play : cellPlays) {
+            counts.times.push_back(play->timeAsInt);
+            counts.seasons.push_back(static_cast<int16_t>(play->season));
+            counts.offenses.push_back(static_cast<int16_t>(play->offenseCode));
+            counts.defenses.push_back(static_cast<int16_t>(play->defenseCode));
+        }
+    }
+    built = true;
+}
+
+
+bool SituationCounts::empty() const {
+    return !built;
+}
+
+
+//amount of plays within the situation bounds, counting only the filtered teams and seasons
+long SituationCounts::count(const SituationBounds& bounds) const {
+    int group = groupIndex(bounds.quarter, bounds.down);
+    //a team that never appears in the data has no plays
+    if (group == -1 || groups[group].cellStarts.empty()
+        || bounds.offenseCode == SituationBounds::UNKNOWN_TEAM || bounds.defenseCode == SituationBounds::UNKNOWN_TEAM) {
+        return 0;
+    }
+    const Group& plays = groups[group];
+    bool filtered = bounds.hasTeamFilter() || bounds.hasSeasonFilter();
+
+    long total = 0;
+    int lowestToGo = max(bounds.toGoLowerBound, 0);
+    int highestToGo = min(bounds.toGoUpperBound, TO_GO_VALUES - 1);
+    int lowestYardLine = max(bounds.yardLineLowerBound, 0);
+    int highestYardLine = min(bounds.yardLineUpperBound, YARD_LINES - 1);
+    for (int toGo = lowestToGo; toGo <= highestToGo; toGo++) {
+        for (int yardLine = lowestYardLine; yardLine <= highestYardLine; yardLine++) {
+            auto cellBegin = plays.times.begin() + plays.cellStarts[toGo*YARD_LINES + yardLine];
+            auto cellEnd = plays.times.begin() + plays.cellStarts[toGo*YARD_LINES + yardLine + 1];
+            if (cellBegin == cellEnd) {
+                continue;
+            }
+            auto first = lower_bound(cellBegin, cellEnd, bounds.timeLowerBound);
+            auto last = upper_bound(first, cellEnd, bounds.timeUpperBound);
+            if (!filtered) {
+                total += last - first;
+                continue;
+            }
+            for (long i = first - plays.times.begin(); i < last - plays.times.begin(); i++) {
+                if ((bounds.offenseCode == SituationBounds::ANY_TEAM || plays.offenses[i] == bounds.offenseCode)
+                    && (bounds.defenseCode == SituationBounds::ANY_TEAM || plays.defenses[i] == bounds.defenseCode)
+                    && plays.seasons[i] >= bounds.firstSeason && plays.seasons[i] <= bounds.lastSeason) {
+                    total++;
+                }
+            }
+        }
+    }
+    return total;
+}
+
+
+//starts from the usual window and widens it until it holds the target, or narrows it while it still does
+AdaptiveWindow SituationCounts::adapt(const Play& currentSituation, const SeasonRange& seasons, int targetSample) const {
+    AdaptiveWindow window;
+    window.targetSample = targetSample;
+    window.level = Helpers::DEFAULT_WINDOW_LEVEL;
+    window.bounds = Helpers::calculateWindowBounds(currentSituation, window.level, seasons);
+    window.count = count(window.bounds);
+
+    if (window.count < targetSample) {
+        while (window.count < targetSample && window.level + 1 < Helpers::WINDOW_LEVELS) {
+            window.level++;
+            window.bounds = Helpers::calculateWindowBounds(currentSituation, window.level, seasons);
+            window.count = count(window.bounds);
+        }
+    }
+    else {
+        while (window.level > 0) {
+            SituationBounds narrower = Helpers::calculateWindowBounds(currentSituation, window.level - 1, seasons);
+            long narrowerCount = count(narrower);
+            if (narrowerCount < targetSample) {
+                break;
+            }
+            window.level--;
+            window.bounds = narrower;
+            window.count = narrowerCount;
+        }
+    }
+    return window;
+}
+
+
+void AdaptiveWindow::print() const {
+    cout << "WINDOW: " << bounds.toGoLowerBound << "-" << bounds.toGoUpperBound << " yards to go, yard line ";
+    cout << bounds.yardLineLowerBound << "-" << bounds.yardLineUpperBound << ", time ";
+    cout << Helpers::formatTime(bounds.timeLowerBound / 100, bounds.timeLowerBound % 100) << "-";
+    cout << Helpers::formatTime(bounds.timeUpperBound / 100, bounds.timeUpperBound % 100);
+    if (bounds.hasTeamFilter() || bounds.hasSeasonFilter()) {
+        cout << " (" << count << " plays of the filtered teams and seasons, target of " << targetSample << ")\n";
+    }
+    else {
+        cout << " (" << count << " plays of every team and season, target of " << targetSample << ")\n";
+    }
+}
+
+
+long SituationCounts::memoryBytes() const {
+    long bytes = static_cast<long>(groups.capacity() * sizeof(Group));
+    for (const Group& group : groups) {
+        bytes += static_cast<long>((group.cellStarts.capacity() + group.times.capacity()) * sizeof(int));
+        bytes += static_cast<long>((group.seasons.capacity() + group.offenses.capacity() + group.defenses.capacity()) * sizeof(int16_t));
+    }
+    return bytes;
+}
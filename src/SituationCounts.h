@@ -0,0 +1,69 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+
+
+#include "Play.h"
+#include "Helpers.h"
+
+
+using namespace std;
+
+
+//bounds chosen by widening or narrowing the window until it holds a target amount of plays
+struct AdaptiveWindow {
+    SituationBounds bounds;
+    int level;
+    long count;
+    int targetSample;
+
+    void print() const;
+};
+
+
+//counts the plays within any bounds without visiting them
+//plays are grouped by quarter and down, then laid out by toGo and yardLine cell with a prefix sum of cell sizes,
+//...so a count is two binary searches over the sorted times of each cell in the window
+//with a team or season filter, the plays between those two searches are checked against it, which reads a few
+//...contiguous small arrays instead of the plays
+class SituationCounts {
+public:
+    //builds the counts over the given plays
+    void build(const vector<const Play*>& plays);
+
+    bool empty() const;
+
+
+    //bytes held by its arrays, for the memory report
+    long memoryBytes() const;
+
+    //amount of plays within the situation bounds, counting only the filtered teams and seasons
+    long count(const SituationBounds& bounds) const;
+
+    //starts from the usual window and widens it until it holds the target, or narrows it while it still does
+    //only the final window's plays are visited afterward
+    AdaptiveWindow adapt(const Play& currentSituation, const SeasonRange& seasons, int targetSample) const;
+
+private:
+    static constexpr int QUARTERS = 6;
+    static constexpr int DOWNS = 5;
+    static constexpr int TO_GO_VALUES = 100;
+    static constexpr int YARD_LINES = 100;
+
+    struct Group {
+        //cellStarts[toGo * YARD_LINES + yardLine] is where the times of that cell start
+        vector<int> cellStarts;
+        //timeAsInt of every play of the group, sorted within each cell
+        vector<int> times;
+        //season and team dictionary codes of the play at the same position of times, read only when filtered
+        vector<int16_t> seasons;
+        vector<int16_t> offenses;
+        vector<int16_t> defenses;
+    };
+
+    //groups[quarter * DOWNS + down], empty if no play has that quarter and down
+    vector<Group> groups;
+    bool built = false;
+
+    static int groupIndex(int quarter, int down);
+};
@@ -0,0 +1,217 @@
+#include <iostream>
+#include <fstream>
+#include <stdexcept>
+#include <algorithm>
+#include <chrono>
+
+
+#include "SituationGrid.h"
+#include "SuccessTally.h"
+#include "PlayDictionary.h"
+#include "WorkerPool.h"
+
+
+using namespace std;
+
+
+namespace {
+    //bins of one quarter and down, toGo 1-26 since the window of toGo 25 reaches 26, and every yardLine 0-99
+    constexpr int TO_GO_BINS = SituationGrid::TO_GO_CELLS + 1;
+    constexpr int YARD_LINE_BINS = 100;
+    //a bin for the plays at each time of a cell and one for the plays between two cells, so the ±1:30 bounds are exact
+    //the bounds of the cell at bin 2c are bins 2c-6 up to 2c+6
+    constexpr int TIME_BINS = 2 * (SituationGrid::TIME_CELLS - 1) + 1;
+    constexpr int TIME_WINDOW_BINS = 90 / SituationGrid::SECONDS_PER_TIME_CELL * 2;
+
+    //the first channels of the bins, the successes of each sub play come after them
+    enum GridChannel {SITUATIONS, FIRST_DOWNS, TOUCHDOWNS, FIELD_GOALS, SUB_PLAY_CHANNELS};
+
+    int timeBinOf(const Play& play) {
+        int secondsLeft = play.minutes*60 + play.seconds;
+        int cell = secondsLeft / SituationGrid::SECONDS_PER_TIME_CELL;
+        return secondsLeft % SituationGrid::SECONDS_PER_TIME_CELL == 0 ? 2 * cell : 2 * cell + 1;
+    }
+
+    //replaces every bin with the sum of the bins from before up to after positions away along one axis
+    //the bins are blocks of length positions, and neighbouring positions are stride apart
+    void slideWindow(vector<int>& bins, int blocks, int length, int stride, int before, int after) {
+        vector<int> prefix(length + 1);
+        for (int block = 0; block < blocks; block++) {
+            for (int offset = 0; offset < stride; offset++) {
+                int* line = bins.data() + static_cast<long>(block) * length * stride + offset;
+                prefix[0] = 0;
+                for (int position = 0; position < length; position++) {
+                    prefix[position + 1] = prefix[position] + line[static_cast<long>(position) * stride];
+                }
+                for (int position = 0; position < length; position++) {
+                    line[static_cast<long>(position) * stride] = prefix[min(length, position + after + 1)] - prefix[max(0, position - before)];
+                }
+            }
+        }
+    }
+}
+
+
+int SituationGrid::cellOf(int quarter, int down, int toGo, int yardLine, int timeCell) {
+    return (((((quarter - 1) * DOWNS + down - 1) * TO_GO_CELLS + toGo - 1) * YARD_LINE_CELLS + yardLine - 1) * TIME_CELLS) + timeCell;
+}
+
+
+//plays are split by quarter and down in one pass, then each worker bins and slides the windows of its own slices
+void SituationGrid::build(const vector<Play>& plays) {
+    auto start = chrono::steady_clock::now();
+    situations.assign(CELLS, 0);
+    firstDownRates.assign(CELLS, 0.0f);
+    touchdownRates.assign(CELLS, 0.0f);
+    fieldGoalRates.assign(CELLS, 0.0f);
+    topSubPlays.assign(CELLS, NO_SUB_PLAY);
+    subPlayNames.clear();
+
+    //counts the same sub play successes a query does, so the top sub play is the first one a query would print
+    SuccessTally tally;
+    vector<vector<int>> slices(QUARTERS * DOWNS);
+    vector<bool> succeeded(PlayDictionary::MAX_PLAY_TYPES * PlayDictionary::MAX_SUB_TYPES, false);
+    for (int row = 0; row < static_cast<int>(plays.size()); row++) {
+        const Play& play = plays[row];
+        if (play.quarter < 1 || play.quarter > QUARTERS || play.down < 1 || play.down > DOWNS || play.toGo < 1
+            || play.toGo > TO_GO_BINS || play.yardLine < 0 || play.yardLine >= YARD_LINE_BINS
+            || play.minutes*60 + play.seconds > (TIME_CELLS - 1) * SECONDS_PER_TIME_CELL) {
+            continue;
+        }
+        slices[(play.quarter - 1) * DOWNS + play.down - 1].push_back(row);
+        int cells[SuccessTally::MAX_SUCCESS_CELLS];
+        int hits = tally.successCells(play, false, cells);
+        for (int i = 0; i < hits; i++) {
+            succeeded[cells[i]] = true;
+        }
+    }
+
+    //sub plays are ordered by name like SuccessTally::rankSubPlays, so ties go to the same sub play
+    vector<int> subPlayCodes;
+    for (int code = 0; code < static_cast<int>(succeeded.size()); code++) {
+        if (succeeded[code]) {
+            subPlayCodes.push_back(code);
+        }
+    }
+    auto playTypeOf = [](int code) -> const string& {
+        return PlayDictionary::decode(PlayDictionary::PLAY_TYPE, code / PlayDictionary::MAX_SUB_TYPES);
+    };
+    auto subTypeOf = [](int code) -> const string& {
+        return PlayDictionary::decode(PlayDictionary::SUB_TYPE, code % PlayDictionary::MAX_SUB_TYPES);
+    };
+    sort(subPlayCodes.begin(), subPlayCodes.end(), [&](int a, int b) {
+        if (playTypeOf(a) != playTypeOf(b)) {
+            return playTypeOf(a) < playTypeOf(b);
+        }
+        return subTypeOf(a) < subTypeOf(b);
+    });
+    //named the way SuccessTally::printSuggestion prints them
+    int fieldGoalCode = PlayDictionary::lookup(PlayDictionary::PLAY_TYPE, "FIELD GOAL");
+    vector<int> channelOf(succeeded.size(), -1);
+    for (int i = 0; i < static_cast<int>(subPlayCodes.size()); i++) {
+        int code = subPlayCodes[i];
+        channelOf[code] = SUB_PLAY_CHANNELS + i;
+        if (code / PlayDictionary::MAX_SUB_TYPES == fieldGoalCode) {
+            subPlayNames.push_back(playTypeOf(code) + " IN " + subTypeOf(code) + " FORMATION");
+        }
+        else {
+            subPlayNames.push_back(playTypeOf(code) + " " + subTypeOf(code));
+        }
+    }
+    int channels = SUB_PLAY_CHANNELS + static_cast<int>(subPlayCodes.size());
+
+    WorkerPool::shared().parallelFor(QUARTERS * DOWNS, [&](int slice) {
+        //bins[((channel * TO_GO_BINS + toGo - 1) * YARD_LINE_BINS + yardLine) * TIME_BINS + timeBin]
+        vector<int> bins(static_cast<long>(channels) * TO_GO_BINS * YARD_LINE_BINS * TIME_BINS, 0);
+        const long channelSize = static_cast<long>(TO_GO_BINS) * YARD_LINE_BINS * TIME_BINS;
+        SuccessTally sliceTally;
+        for (int row : slices[slice]) {
+            const Play& play = plays[row];
+            long bin = (static_cast<long>(play.toGo - 1) * YARD_LINE_BINS + play.yardLine) * TIME_BINS + timeBinOf(play);
+            bins[SITUATIONS * channelSize + bin]++;
+            if (play.resultIsFirstDown) {
+                bins[FIRST_DOWNS * channelSize + bin]++;
+            }
+            if (play.isTouchdown) {
+                bins[TOUCHDOWNS * channelSize + bin]++;
+            }
+            if (play.outcomes & FIELD_GOAL_OUTCOME) {
+                bins[FIELD_GOALS * channelSize + bin]++;
+            }
+            int cells[SuccessTally::MAX_SUCCESS_CELLS];
+            int hits = sliceTally.successCells(play, false, cells);
+            for (int i = 0; i < hits; i++) {
+                bins[channelOf[cells[i]] * channelSize + bin]++;
+            }
+        }
+
+        //the windows are boxes, so summing along time, then yardLine, then toGo gives the sum over the whole box
+        slideWindow(bins, channels * TO_GO_BINS * YARD_LINE_BINS, TIME_BINS, 1, TIME_WINDOW_BINS, TIME_WINDOW_BINS);
+        slideWindow(bins, channels * TO_GO_BINS, YARD_LINE_BINS, TIME_BINS, 5, 5);
+        slideWindow(bins, channels, TO_GO_BINS, YARD_LINE_BINS * TIME_BINS, 1, 1);
+
+        int quarter = slice / DOWNS + 1;
+        int down = slice % DOWNS + 1;
+        for (int toGo = 1; toGo <= TO_GO_CELLS; toGo++) {
+            for (int yardLine = 1; yardLine <= YARD_LINE_CELLS; yardLine++) {
+                for (int timeCell = 0; timeCell < TIME_CELLS; timeCell++) {
+                    long bin = (static_cast<long>(toGo - 1) * YARD_LINE_BINS + yardLine) * TIME_BINS + 2 * timeCell;
+                    int count = bins[SITUATIONS * channelSize + bin];
+                    if (count == 0) {
+                        continue;
+                    }
+                    int cell = cellOf(quarter, down, toGo, yardLine, timeCell);
+                    situations[cell] = static_cast<uint32_t>(count);
+                    firstDownRates[cell] = static_cast<float>(bins[FIRST_DOWNS * channelSize + bin]) / static_cast<float>(count);
+                    touchdownRates[cell] = static_cast<float>(bins[TOUCHDOWNS * channelSize + bin]) / static_cast<float>(count);
+                    fieldGoalRates[cell] = static_cast<float>(bins[FIELD_GOALS * channelSize + bin]) / static_cast<float>(count);
+                    int mostSuccesses = 0;
+                    for (int channel = SUB_PLAY_CHANNELS; channel < channels; channel++) {
+                        int successes = bins[channel * channelSize + bin];
+                        if (successes > mostSuccesses) {
+                            mostSuccesses = successes;
+                            topSubPlays[cell] = static_cast<int16_t>(channel - SUB_PLAY_CHANNELS);
+                        }
+                    }
+                }
+            }
+        }
+    });
+    seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+
+long SituationGrid::write(const string& filename) const {
+    ofstream file(filename, ios::binary);
+    if (!file.is_open()) {
+        throw runtime_error("Could not write " + filename);
+    }
+
+    const char magic[4] = {'G', 'G', 'G', 'R'};
+    int header[6] = {QUARTERS, DOWNS, TO_GO_CELLS, YARD_LINE_CELLS, TIME_CELLS, static_cast<int>(subPlayNames.size())};
+    file.write(magic, sizeof(magic));
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    for (const string& name : subPlayNames) {
+        unsigned char length = static_cast<unsigned char>(min<size_t>(name.size(), 255));
+        file.put(static_cast<char>(length));
+        file.write(name.data(), length);
+    }
+    file.write(reinterpret_cast<const char*>(situations.data()), static_cast<streamsize>(situations.size() * sizeof(uint32_t)));
+    for (const vector<float>* rates : {&firstDownRates, &touchdownRates, &fieldGoalRates}) {
+        file.write(reinterpret_cast<const char*>(rates->data()), static_cast<streamsize>(rates->size() * sizeof(float)));
+    }
+    file.write(reinterpret_cast<const char*>(topSubPlays.data()), static_cast<streamsize>(topSubPlays.size() * sizeof(int16_t)));
+    if (!file) {
+        throw runtime_error("Could not write " + filename);
+    }
+    return static_cast<long>(file.tellp());
+}
+
+
+void SituationGrid::print() const {
+    long filled = count_if(situations.begin(), situations.end(), [](uint32_t count) {
+        return count > 0;
+    });
+    cout << "Computed " << CELLS << " situation cells (" << filled << " with similar plays) and "
+         << subPlayNames.size() << " sub plays in " << seconds << " seconds\n";
+}
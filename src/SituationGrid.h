@@ -0,0 +1,60 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+
+
+#include "Play.h"
+
+
+using namespace std;
+
+
+//likelihoods of every situation the console can be asked about, computed at once for the dashboard's heatmaps
+//each cell holds what a query of that situation would find within the same ±1 toGo, ±5 yardLine and ±1:30 bounds
+//(see Helpers::calculateSituationBounds), over every season and team, with the time bounds clamped to 0:00 and 15:00
+//
+//the plays of each quarter and down are counted into bins once, then the bounds are applied as sliding window sums
+//along each axis, so a cell costs a few additions instead of a scan of the plays
+class SituationGrid {
+public:
+    //quarters 1-5 (overtime is 5), downs 1-4, two point conversions have no grid since their toGo and yardLine are fixed
+    static constexpr int QUARTERS = 5;
+    static constexpr int DOWNS = 4;
+    //toGo 1-25, longer yards to go are too rare to color a heatmap
+    static constexpr int TO_GO_CELLS = 25;
+    //yardLine 1-99
+    static constexpr int YARD_LINE_CELLS = 99;
+    //time left of 0:00, 0:30, ... 15:00
+    static constexpr int TIME_CELLS = 31;
+    static constexpr int SECONDS_PER_TIME_CELL = 30;
+    static constexpr int CELLS = QUARTERS * DOWNS * TO_GO_CELLS * YARD_LINE_CELLS * TIME_CELLS;
+    //topSubPlay of a cell where nothing succeeded
+    static constexpr int16_t NO_SUB_PLAY = -1;
+
+    //one value per cell for every column, indexed by cellOf
+    vector<uint32_t> situations;
+    vector<float> firstDownRates;
+    vector<float> touchdownRates;
+    vector<float> fieldGoalRates;
+    //index into subPlayNames of the sub play with the most successes, like the first one a query prints
+    vector<int16_t> topSubPlays;
+    //play type and sub type of every sub play that succeeded somewhere, like "PASS SHORT LEFT"
+    vector<string> subPlayNames;
+
+    double seconds = 0;
+
+    //counts the plays into the grid, each quarter and down on its own worker
+    void build(const vector<Play>& plays);
+
+    static int cellOf(int quarter, int down, int toGo, int yardLine, int timeCell);
+
+    //writes the tensor in little-endian binary, throws runtime_error if the file can't be written
+    //   "GGGR", int dimensions[5] = {QUARTERS, DOWNS, TO_GO_CELLS, YARD_LINE_CELLS, TIME_CELLS}
+    //   int sub play count, then every sub play name as a byte of its length and its characters
+    //   situations (uint32), first down, touchdown and field goal rates (float), top sub plays (int16), CELLS of each
+    //returns the bytes written
+    long write(const string& filename) const;
+
+    void print() const;
+};
@@ -0,0 +1,286 @@
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+
+
+#include "SituationKdTree.h"
+#include "PlayDictionary.h"
+
+
+using namespace std;
+
+
+//one unit of distance is a quarter, a down, 3 yards to go, 10 yards of field position, or 3 minutes
+void SituationKdTree::normalize(const Play& play, float coords[DIMENSIONS]) {
+    coords[0] = static_cast<float>(play.quarter);
+    coords[1] = static_cast<float>(play.down);
+    coords[2] = static_cast<float>(play.toGo) / 3.0f;
+    coords[3] = static_cast<float>(play.yardLine) / 10.0f;
+    coords[4] = static_cast<float>(play.minutes*60 + play.seconds) / 180.0f;
+}
+
+
+void SituationKdTree::build(const vector<const Play*>& plays) {
+    points.resize(plays.size());
+    all = Tree();
+    offenseTrees.assign(PlayDictionary::MAX_TEAMS, Tree());
+    defenseTrees.assign(PlayDictionary::MAX_TEAMS, Tree());
+    seasons.clear();
+    for (const Play* play : plays) {
+        seasons.push_back(play->season);
+    }
+    sort(seasons.begin(), seasons.end());
+    seasons.erase(unique(seasons.begin(), seasons.end()), seasons.end());
+    seasonTrees.assign(seasons.size(), Tree());
+
+    for (int i = 0; i < static_cast<int>(plays.size()); i++) {
+        const Play& play = *plays[i];
+        normalize(play, points[i].coords);
+        points[i].play = &play;
+        all.rows.push_back(i);
+        if (play.offenseCode >= 0 && play.offenseCode < PlayDictionary::MAX_TEAMS) {
+            offenseTrees[play.offenseCode].rows.push_back(i);
+        }
+        if (play.defenseCode >= 0 && play.defenseCode < PlayDictionary::MAX_TEAMS) {
+            defenseTrees[play.defenseCode].rows.push_back(i);
+        }
+        seasonTrees[lower_bound(seasons.begin(), seasons.end(), play.season) - seasons.begin()].rows.push_back(i);
+    }
+
+    buildTree(all);
+    for (vector<Tree>* trees : {&offenseTrees, &defenseTrees, &seasonTrees}) {
+        for (Tree& tree : *trees) {
+            buildTree(tree);
+        }
+    }
+}
+
+
+void SituationKdTree::buildTree(Tree& tree) {
+    tree.axes.assign(tree.rows.size(), 0);
+    buildRange(tree, 0, static_cast<int>(tree.rows.size()));
+}
+
+
+long SituationKdTree::Tree::memoryBytes() const {
+    return static_cast<long>(rows.capacity() * sizeof(int) + axes.capacity());
+}
+
+
+//splits on the axis with the widest spread so clustered dimensions like down don't waste levels
+void SituationKdTree::buildRange(Tree& tree, int low, int high) {
+    vector<int>& rows = tree.rows;
+    if (high - low <= LEAF_SIZE) {
+        return;
+    }
+
+    float lowest[DIMENSIONS];
+    float highest[DIMENSIONS];
+    for (int d = 0; d < DIMENSIONS; d++) {
+        lowest[d] = highest[d] = points[rows[low]].coords[d];
+    }
+    for (int i = low + 1; i < high; i++) {
+        for (int d = 0; d < DIMENSIONS; d++) {
+            lowest[d] = min(lowest[d], points[rows[i]].coords[d]);
+            highest[d] = max(highest[d], points[rows[i]].coords[d]);
+        }
+    }
+    int axis = 0;
+    for (int d = 1; d < DIMENSIONS; d++) {
+        if (highest[d] - lowest[d] > highest[axis] - lowest[axis]) {
+            axis = d;
+        }
+    }
+
+    int middle = low + (high - low) / 2;
+    nth_element(rows.begin() + low, rows.begin() + middle, rows.begin() + high, [&](int a, int b) {
+        return points[a].coords[axis] < points[b].coords[axis];
+    });
+    tree.axes[middle] = static_cast<unsigned char>(axis);
+
+    buildRange(tree, low, middle);
+    buildRange(tree, middle + 1, high);
+}
+
+
+bool SituationKdTree::empty() const {
+    return points.empty();
+}
+
+
+bool SituationKdTree::passesFilters(const Play& play, const SituationBounds& filters) {
+    return (filters.offenseCode == SituationBounds::ANY_TEAM || play.offenseCode == filters.offenseCode)
+           && (filters.defenseCode == SituationBounds::ANY_TEAM || play.defenseCode == filters.defenseCode)
+           && play.season >= filters.firstSeason && play.season <= filters.lastSeason;
+}
+
+
+//uses the smallest of the filtered offense's tree, the filtered defense's tree and the trees of the filtered seasons
+vector<const SituationKdTree::Tree*> SituationKdTree::treesFor(const SituationBounds& filters) const {
+    vector<const Tree*> trees = {&all};
+    long size = static_cast<long>(all.rows.size());
+    auto useSmaller = [&](const vector<Tree>& teamTrees, int code) {
+        if (code >= 0 && code < PlayDictionary::MAX_TEAMS && static_cast<long>(teamTrees[code].rows.size()) < size) {
+            trees = {&teamTrees[code]};
+            size = static_cast<long>(teamTrees[code].rows.size());
+        }
+    };
+    useSmaller(offenseTrees, filters.offenseCode);
+    useSmaller(defenseTrees, filters.defenseCode);
+    if (filters.hasSeasonFilter()) {
+        vector<const Tree*> filteredSeasons;
+        long seasonSize = 0;
+        for (int i = 0; i < static_cast<int>(seasons.size()); i++) {
+            if (seasons[i] >= filters.firstSeason && seasons[i] <= filters.lastSeason) {
+                filteredSeasons.push_back(&seasonTrees[i]);
+                seasonSize += static_cast<long>(seasonTrees[i].rows.size());
+            }
+        }
+        if (seasonSize < size) {
+            trees = filteredSeasons;
+        }
+    }
+    return trees;
+}
+
+
+//returns the k plays closest to the current situation, closest first
+vector<Neighbor> SituationKdTree::nearest(const Play& currentSituation, const SituationBounds& filters, int k) const {
+    vector<Neighbor> neighbors;
+    //a team that never appears in the data can't have neighbours
+    if (k <= 0 || filters.offenseCode == SituationBounds::UNKNOWN_TEAM || filters.defenseCode == SituationBounds::UNKNOWN_TEAM) {
+        return neighbors;
+    }
+
+    float query[DIMENSIONS];
+    normalize(currentSituation, query);
+
+    //max heap of pair<squared distance, position in points> holding the k closest so far
+    //it is shared by every tree searched, so each one is pruned by what the others found
+    vector<pair<float, int>> best;
+    for (const Tree* tree : treesFor(filters)) {
+        searchRange(*tree, 0, static_cast<int>(tree->rows.size()), query, filters, k, best);
+    }
+
+    sort_heap(best.begin(), best.end());
+    for (const pair<float, int>& found : best) {
+        neighbors.push_back({sqrt(found.first), points[found.second].play});
+    }
+    return neighbors;
+}
+
+
+//visits the side of the split the query is on first and only crosses the split if it is closer than the kth best
+void SituationKdTree::searchRange(const Tree& tree, int low, int high, const float query[DIMENSIONS],
+                                  const SituationBounds& filters, int k, vector<pair<float, int>>& best) const {
+    auto consider = [&](int index) {
+        const Point& point = points[tree.rows[index]];
+        if (!passesFilters(*point.play, filters)) {
+            return;
+        }
+        float distance = 0;
+        for (int d = 0; d < DIMENSIONS; d++) {
+            float difference = point.coords[d] - query[d];
+            distance += difference*difference;
+        }
+        pair<float, int> candidate = {distance, tree.rows[index]};
+        if (static_cast<int>(best.size()) < k) {
+            best.push_back(candidate);
+            push_heap(best.begin(), best.end());
+        }
+        else if (candidate < best.front()) {
+            pop_heap(best.begin(), best.end());
+            best.back() = candidate;
+            push_heap(best.begin(), best.end());
+        }
+    };
+
+    if (high - low <= LEAF_SIZE) {
+        for (int i = low; i < high; i++) {
+            consider(i);
+        }
+        return;
+    }
+
+    int middle = low + (high - low) / 2;
+    int axis = tree.axes[middle];
+    float split = query[axis] - points[tree.rows[middle]].coords[axis];
+    consider(middle);
+
+    if (split < 0) {
+        searchRange(tree, low, middle, query, filters, k, best);
+        if (static_cast<int>(best.size()) < k || split*split <= best.front().first) {
+            searchRange(tree, middle + 1, high, query, filters, k, best);
+        }
+    }
+    else {
+        searchRange(tree, middle + 1, high, query, filters, k, best);
+        if (static_cast<int>(best.size()) < k || split*split <= best.front().first) {
+            searchRange(tree, low, middle, query, filters, k, best);
+        }
+    }
+}
+
+
+//prints likelihoods weighted by 1/(1 + distance) and the closest plays
+void SituationKdTree::printNeighbors(const Play& currentSituation, const vector<Neighbor>& neighbors) {
+    if (neighbors.empty()) {
+        cout << "No similar situations found either! Good Luck!\n\n";
+        return;
+    }
+
+    float totalWeight = 0;
+    float firstDownWeight = 0;
+    float touchdownWeight = 0;
+    float fieldGoalWeight = 0;
+    float twoPointWeight = 0;
+    for (const Neighbor& neighbor : neighbors) {
+        float weight = 1.0f / (1.0f + neighbor.distance);
+        totalWeight += weight;
+        firstDownWeight += (neighbor.play->outcomes & FIRST_DOWN_OUTCOME) ? weight : 0.0f;
+        touchdownWeight += (neighbor.play->outcomes & TOUCHDOWN_OUTCOME) ? weight : 0.0f;
+        fieldGoalWeight += (neighbor.play->outcomes & FIELD_GOAL_OUTCOME) ? weight : 0.0f;
+        twoPointWeight += (neighbor.play->outcomes & TWO_POINT_OUTCOME) ? weight : 0.0f;
+    }
+
+    cout << "THE " << neighbors.size() << " MOST SIMILAR SITUATIONS ARE UP TO ";
+    cout << Helpers::formatPercentages(neighbors.back().distance) << " AWAY, THEIR DISTANCE-WEIGHTED LIKELIHOODS ARE:\n";
+    if (currentSituation.isTwoPointConversion) {
+        cout << "    Two Point Conversion: " << Helpers::formatPercentages(twoPointWeight/totalWeight*100) << "%\n";
+    }
+    else {
+        cout << "    Field Goal: " << Helpers::formatPercentages(fieldGoalWeight/totalWeight*100) << "%\n";
+        cout << "    First Down: " << Helpers::formatPercentages(firstDownWeight/totalWeight*100) << "%\n";
+        cout << "    Touchdown: " << Helpers::formatPercentages(touchdownWeight/totalWeight*100) << "%\n";
+    }
+
+    cout << "CLOSEST HISTORICAL PLAYS:\n";
+    int rank = 1;
+    for (const Neighbor& neighbor : neighbors) {
+        const Play& play = *neighbor.play;
+        cout << "    " << rank << ". " << play.playType;
+        if (play.isPass) {
+            cout << " " << play.passType;
+        }
+        else if (play.isRush) {
+            cout << " " << play.rushDirection;
+        }
+        cout << " (" << play.resultingYards << " yards) in quarter " << play.quarter << " on down " << play.down;
+        cout << " and " << play.toGo << " on the " << play.yardLine << " yard line at ";
+        cout << Helpers::formatTime(play.minutes, play.seconds) << " - Game ID: " << play.gameID << endl;
+        rank++;
+    }
+    cout << endl;
+}
+
+
+long SituationKdTree::memoryBytes() const {
+    long bytes = static_cast<long>(points.capacity() * sizeof(Point)) + all.memoryBytes() + static_cast<long>(seasons.capacity() * sizeof(int));
+    for (const vector<Tree>* trees : {&offenseTrees, &defenseTrees, &seasonTrees}) {
+        bytes += static_cast<long>(trees->capacity() * sizeof(Tree));
+        for (const Tree& tree : *trees) {
+            bytes += tree.memoryBytes();
+        }
+    }
+    return bytes;
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include <vector>
+
+
+#include "Play.h"
+#include "Helpers.h"
+
+
+using namespace std;
+
+
+//a play found by a nearest neighbour search along with its distance from the current situation
+struct Neighbor {
+    float distance;
+    const Play* play;
+};
+
+
+//k-d tree over the normalized situation of every play (quarter, down, toGo, yardLine, time left in quarter)
+//built once at ingest so the K most similar plays are found without widening any bounds
+//every play is also put in a tree of its offense, its defense and its season, so a filtered search descends only the
+//...smallest of those its filters allow instead of a tree whose nearest plays mostly fail the filters
+class SituationKdTree {
+public:
+    static constexpr int DIMENSIONS = 5;
+
+    //builds the tree over the given plays, which have to outlive it
+    void build(const vector<const Play*>& plays);
+
+    bool empty() const;
+
+
+    //bytes held by its arrays, for the memory report
+    long memoryBytes() const;
+
+    //returns the k plays closest to the current situation, closest first
+    //plays outside the team and season filters of the bounds are never returned
+    vector<Neighbor> nearest(const Play& currentSituation, const SituationBounds& filters, int k) const;
+
+    //prints likelihoods weighted by 1/(1 + distance) and the closest plays
+    static void printNeighbors(const Play& currentSituation, const vector<Neighbor>& neighbors);
+
+private:
+    struct Point {
+        float coords[DIMENSIONS];
+        const Play* play;
+    };
+
+    //the normalized situation of every play, in the order the plays were given
+    vector<Point> points;
+
+    //a tree holds positions into points, so a play in several trees is only normalized and stored once
+    struct Tree {
+        //nodes are stored implicitly, the node of the range [low, high) is its middle position
+        vector<int> rows;
+        //splitting axis of the node at each middle position
+        vector<unsigned char> axes;
+
+        long memoryBytes() const;
+    };
+
+    //every play
+    Tree all;
+    //the plays of each team, indexed by team dictionary code
+    vector<Tree> offenseTrees;
+    vector<Tree> defenseTrees;
+    //the plays of each season, from earliest to latest
+    vector<int> seasons;
+    vector<Tree> seasonTrees;
+
+    static constexpr int LEAF_SIZE = 8;
+
+    static void normalize(const Play& play, float coords[DIMENSIONS]);
+
+    void buildTree(Tree& tree);
+
+    void buildRange(Tree& tree, int low, int high);
+
+    //the trees holding every play that passes the filters, the ones with the fewest points
+    vector<const Tree*> treesFor(const SituationBounds& filters) const;
+
+    //best is a max heap of pair<squared distance, position in points> holding the k closest so far
+    void searchRange(const Tree& tree, int low, int high, const float query[DIMENSIONS], const SituationBounds& filters,
+                     int k, vector<pair<float, int>>& best) const;
+
+    static bool passesFilters(const Play& play, const SituationBounds& filters);
+};
@@ -0,0 +1,407 @@
+#include <iostream>
+#include <algorithm>
+
+
+#include "SuccessTally.h"
+#include "Helpers.h"
+#include "ConfidenceIntervals.h"
+
+
+using namespace std;
+
+
+SuccessTally::SuccessTally() {
+    subPlaySuccesses.assign(PlayDictionary::MAX_PLAY_TYPES * PlayDictionary::MAX_SUB_TYPES, 0);
+
+    //codes are looked up once per query so matched plays are only compared as integers
+    //a value the data doesn't have is -1, which no play's code matches, and queries never add to the dictionary
+    extraPointCode = PlayDictionary::lookup(PlayDictionary::PLAY_TYPE, "EXTRA POINT");
+    fieldGoalCode = PlayDictionary::lookup(PlayDictionary::PLAY_TYPE, "FIELD GOAL");
+    twoPointPassCode = PlayDictionary::lookup(PlayDictionary::SUB_TYPE, "PASS");
+    twoPointRushCode = PlayDictionary::lookup(PlayDictionary::SUB_TYPE, "RUSH");
+}
+
+
+void SuccessTally::add(const Play& play, bool twoPointQuery) {
+    situations++;
+
+    //if it's determining a two point conversion
+    if (twoPointQuery && play.isTwoPointConversion && play.playTypeCode != extraPointCode) {
+
+        //calculating likelihood of successful conversion in situation
+        if (play.isTwoPointConversionSuccessful) {
+            conversions++;
+            //the .csv doesn't specify if a conversion was a pass or rush, so it is parsed from the description at ingest
+            if (play.twoPointMethod == TWO_POINT_PASS) {
+                twoPointPasses++;
+            }
+            else if (play.twoPointMethod == TWO_POINT_RUSH) {
+                twoPointRushes++;
+            }
+        }
+    }
+    //if it's not determining a two point conversion
+    else {
+        //calculating likelihood of first down in situation
+        if (play.resultIsFirstDown) {
+            firstDowns++;
+            if (play.isPass) {
+                firstDownPasses++;
+            }
+            else if (play.isRush) {
+                firstDownRushes++;
+            }
+        }
+
+        //calculating likelihood of TD in situation
+        if (play.isTouchdown) {
+            touchdowns++;
+            if (play.isPass) {
+                touchdownPasses++;
+            }
+            else if (play.isRush) {
+                touchdownRushes++;
+            }
+        }
+
+        //calculating likelihood of successful field goal in situation
+        if (play.playTypeCode == fieldGoalCode && (play.outcomes & FIELD_GOAL_OUTCOME)) {
+            fieldGoals++;
+        }
+    }
+
+    int cells[MAX_SUCCESS_CELLS];
+    int hits = successCells(play, twoPointQuery, cells);
+    for (int i = 0; i < hits; i++) {
+        subPlaySuccesses[cells[i]]++;
+    }
+}
+
+
+//fills cells with the index into subPlaySuccesses of every sub play success of a play, returns how many there are
+//a play that is both a first down and a touchdown counts twice for its pass type or rush direction
+int SuccessTally::successCells(const Play& play, bool twoPointQuery, int cells[MAX_SUCCESS_CELLS]) const {
+    int row = play.playTypeCode * PlayDictionary::MAX_SUB_TYPES;
+    int hits = 0;
+
+    if (twoPointQuery && play.isTwoPointConversion && play.playTypeCode != extraPointCode) {
+        if (play.isTwoPointConversionSuccessful) {
+            if (play.twoPointMethod == TWO_POINT_PASS && twoPointPassCode != -1) {
+                cells[hits++] = row + twoPointPassCode;
+            }
+            else if (play.twoPointMethod == TWO_POINT_RUSH && twoPointRushCode != -1) {
+                cells[hits++] = row + twoPointRushCode;
+            }
+        }
+        return hits;
+    }
+
+    //for specific pass type or rush dir
+    int subTypeCode = play.isPass ? play.passTypeCode : play.rushDirectionCode;
+    if (play.resultIsFirstDown && (play.isPass || play.isRush)) {
+        cells[hits++] = row + subTypeCode;
+    }
+    if (play.isTouchdown && (play.isPass || play.isRush)) {
+        cells[hits++] = row + subTypeCode;
+    }
+    //for specific formation
+    if (play.playTypeCode == fieldGoalCode && (play.outcomes & FIELD_GOAL_OUTCOME)) {
+        cells[hits++] = row + play.formationCode;
+    }
+    return hits;
+}
+
+
+//adds the counts of another tally into this one
+void SuccessTally::merge(const SuccessTally& other) {
+    situations += other.situations;
+    firstDowns += other.firstDowns;
+    touchdowns += other.touchdowns;
+    conversions += other.conversions;
+    fieldGoals += other.fieldGoals;
+    firstDownPasses += other.firstDownPasses;
+    firstDownRushes += other.firstDownRushes;
+    touchdownPasses += other.touchdownPasses;
+    touchdownRushes += other.touchdownRushes;
+    twoPointPasses += other.twoPointPasses;
+    twoPointRushes += other.twoPointRushes;
+
+    if (other.subPlaySuccesses.empty()) {
+        for (const SubPlaySuccess& successfulPlay : other.sparseSuccesses) {
+            subPlaySuccesses[successfulPlay.playTypeCode * PlayDictionary::MAX_SUB_TYPES + successfulPlay.subTypeCode] += successfulPlay.successes;
+        }
+    }
+    else {
+        for (int i = 0; i < static_cast<int>(subPlaySuccesses.size()); i++) {
+            subPlaySuccesses[i] += other.subPlaySuccesses[i];
+        }
+    }
+}
+
+
+//keeps only the non-zero successes so a tally can be stored cheaply
+void SuccessTally::compact() {
+    sparseSuccesses.clear();
+    for (int i = 0; i < static_cast<int>(subPlaySuccesses.size()); i++) {
+        if (subPlaySuccesses[i] > 0) {
+            sparseSuccesses.push_back({subPlaySuccesses[i], i / PlayDictionary::MAX_SUB_TYPES, i % PlayDictionary::MAX_SUB_TYPES});
+        }
+    }
+    subPlaySuccesses.clear();
+    subPlaySuccesses.shrink_to_fit();
+}
+
+
+//keeps a sub play if it has more successes than every sub play before it in alphabetical order
+//...so the ranking matches the one the original nested maps of strings produced
+vector<SubPlaySuccess> SuccessTally::rankSubPlays() const {
+    vector<SubPlaySuccess> successfulPlays;
+    for (int playTypeCode = 0; playTypeCode < PlayDictionary::MAX_PLAY_TYPES; playTypeCode++) {
+        for (int subTypeCode = 0; subTypeCode < PlayDictionary::MAX_SUB_TYPES; subTypeCode++) {
+            int successes = subPlaySuccesses[playTypeCode * PlayDictionary::MAX_SUB_TYPES + subTypeCode];
+            if (successes > 0) {
+                successfulPlays.push_back({successes, playTypeCode, subTypeCode});
+            }
+        }
+    }
+
+    //only the few sub plays that had a success are sorted
+    sort(successfulPlays.begin(), successfulPlays.end(), [](const SubPlaySuccess& a, const SubPlaySuccess& b) {
+        const string& playTypeA = PlayDictionary::decode(PlayDictionary::PLAY_TYPE, a.playTypeCode);
+        const string& playTypeB = PlayDictionary::decode(PlayDictionary::PLAY_TYPE, b.playTypeCode);
+        if (playTypeA != playTypeB) {
+            return playTypeA < playTypeB;
+        }
+        return PlayDictionary::decode(PlayDictionary::SUB_TYPE, a.subTypeCode)
+               < PlayDictionary::decode(PlayDictionary::SUB_TYPE, b.subTypeCode);
+    });
+
+    vector<SubPlaySuccess> rankedPlays;
+    int mostSuccesses = -1;
+    for (const SubPlaySuccess& successfulPlay : successfulPlays) {
+        if (successfulPlay.successes > mostSuccesses) {
+            rankedPlays.push_back(successfulPlay);
+            mostSuccesses = successfulPlay.successes;
+        }
+    }
+
+    //prints in descending order of successes
+    reverse(rankedPlays.begin(), rankedPlays.end());
+    return rankedPlays;
+}
+
+
+//prints likelihoods and the best historical play, along with recency-weighted likelihoods and intervals if given
+void SuccessTally::printSuggestion(const Play& currentSituation, const Play& bestPlay, const WeightedRates* weighted,
+                                   const LikelihoodIntervals* intervals) const {
+    //pair<likelihood, name> kept in alphabetical order by name so ties print in the same order as before
+    vector<pair<float, string>> likelihoods;
+
+    //likelihoods for first downs
+    float likelihoodFirstDown = (static_cast<float>(firstDowns)/static_cast<float>(situations))*100;
+    float likelihoodFirstDownPass = 0;
+    float likelihoodFirstDownRush = 0;
+    //so that it doesn't divide by 0
+    if (firstDowns != 0) {
+        likelihoodFirstDownPass = (static_cast<float>(firstDownPasses)/static_cast<float>(firstDowns))*100;
+        likelihoodFirstDownRush = (static_cast<float>(firstDownRushes)/static_cast<float>(firstDowns))*100;
+    }
+
+    //likelihoods for touchdowns
+    float likelihoodTouchdown = (static_cast<float>(touchdowns)/static_cast<float>(situations))*100;
+    float likelihoodTouchdownPass = 0;
+    float likelihoodTouchdownRush = 0;
+    //so that it doesn't divide by 0
+    if (touchdowns != 0) {
+        likelihoodTouchdownPass = (static_cast<float>(touchdownPasses)/static_cast<float>(touchdowns))*100;
+        likelihoodTouchdownRush = (static_cast<float>(touchdownRushes)/static_cast<float>(touchdowns))*100;
+    }
+
+    //likelihoods for conversions
+    float likelihoodTwoPoint = (static_cast<float>(conversions)/static_cast<float>(situations))*100;
+    //likelihood of conversion not into map because if calculating for conversion, will be the only one printed
+    //...so it will not need to be sorted
+    float likelihoodTwoPointPass = 0;
+    float likelihoodTwoPointRush = 0;
+    //so that it doesn't divide by 0
+    if (conversions != 0) {
+        likelihoodTwoPointPass = (static_cast<float>(twoPointPasses)/static_cast<float>(conversions))*100;
+        likelihoodTwoPointRush = (static_cast<float>(twoPointRushes)/static_cast<float>(conversions))*100;
+    }
+
+    //likelihood for field goals
+    float likelihoodFieldGoal = 0.0f;
+    //so that it doesn't divide by 0
+    if (fieldGoals != 0) {
+        likelihoodFieldGoal = (static_cast<float>(fieldGoals)/static_cast<float>(situations))*100;
+    }
+
+    //sorts the three likelihoods from greatest to least, keeping alphabetical order for ties
+    likelihoods.push_back({likelihoodFieldGoal, "Field Goal: "});
+    likelihoods.push_back({likelihoodFirstDown, "First Down: "});
+    likelihoods.push_back({likelihoodTouchdown, "Touchdown: "});
+    stable_sort(likelihoods.begin(), likelihoods.end(), [](const pair<float, string>& a, const pair<float, string>& b) {
+        return a.first > b.first;
+    });
+
+    //keeps 1 if it has the most successes and keeps multiple if successes are the same for 2 different plays
+    vector<SubPlaySuccess> successfulPlays = rankSubPlays();
+
+    cout << "\nOUT OF " << situations << " SIMILAR SITUATIONS, ";
+    //if plural amount of successful plays
+    if (successfulPlays.size() > 1) {
+        cout << "THE IDEAL PLAYS' LIKELIHOODS ARE:\n";
+    }
+    else {
+        cout << "THE IDEAL PLAY'S LIKELIHOOD IS:\n";
+    }
+
+
+    //prints ideal plays in descending order of occurrences with their respective plays
+    for (int i = 0; i < static_cast<int>(successfulPlays.size()); i++) {
+        const SubPlaySuccess& successfulPlay = successfulPlays[i];
+        float subPlayLikelihood = (static_cast<float>(successfulPlay.successes)/static_cast<float>(situations))*100;
+        const string& playType = PlayDictionary::decode(PlayDictionary::PLAY_TYPE, successfulPlay.playTypeCode);
+        const string& subType = PlayDictionary::decode(PlayDictionary::SUB_TYPE, successfulPlay.subTypeCode);
+        if (successfulPlay.playTypeCode == fieldGoalCode) {
+            cout << "    " << playType << " IN " << subType << " FORMATION: ";
+        }
+        else {
+            cout << "    " << playType << " " << subType << ": ";
+        }
+        cout << Helpers::formatPercentages(subPlayLikelihood) << "%";
+        if (intervals != nullptr && i < static_cast<int>(intervals->subPlays.size())) {
+            cout << ConfidenceIntervals::format(intervals->subPlays[i]);
+        }
+        cout << "\n";
+    }
+
+    cout << "\nLIKELIHOODS:\n";
+    if (intervals != nullptr && intervals->method == "BOOTSTRAP") {
+        cout << "    (intervals from " << intervals->resamples << " bootstrap resamples)\n";
+    }
+    else if (intervals != nullptr) {
+        cout << "    (Wilson intervals, bootstrapping would exceed the latency budget)\n";
+    }
+
+    //only prints 2 pt conversion if the inputted situation prompted for 2 pt conversion likelihood
+    if (currentSituation.isTwoPointConversion) {
+        cout << "    Two Point Conversion: " << Helpers::formatPercentages(likelihoodTwoPoint) << "%";
+        if (intervals != nullptr) {
+            cout << ConfidenceIntervals::format(intervals->twoPoint);
+        }
+        cout << "\n";
+        cout << "        Two Point Pass: " << Helpers::formatPercentages(likelihoodTwoPointPass) << "%\n";
+        cout << "        Two Point Rush: " << Helpers::formatPercentages(likelihoodTwoPointRush) << "%\n";
+    }
+    else {
+        //orders from greatest to least likelihoods in printing
+        for (auto iter = likelihoods.begin(); iter != likelihoods.end(); iter++) {
+            //ignores likelihoods of 0%
+            if (iter->first != 0) {
+                cout << "    " << iter->second << Helpers::formatPercentages(iter->first) << "%";
+                if (intervals != nullptr) {
+                    //the name tells which interval goes with the likelihood
+                    const Interval& interval = iter->second.find("Fir") != string::npos ? intervals->firstDown
+                                               : iter->second.find("To") != string::npos ? intervals->touchdown
+                                               : intervals->fieldGoal;
+                    cout << ConfidenceIntervals::format(interval);
+                }
+                cout << "\n";
+                //if it's a first down
+                if (iter->second.find("Fir") != string::npos) {
+                    cout << "        Passing: " << Helpers::formatPercentages(likelihoodFirstDownPass) << "%\n";
+                    cout << "        Rushing: " << Helpers::formatPercentages(likelihoodFirstDownRush) << "%\n";
+                }
+                //if it's a touchdown
+                else if (iter->second.find("To") != string::npos){
+                    cout << "        Passing: " << Helpers::formatPercentages(likelihoodTouchdownPass) << "%\n";
+                    cout << "        Rushing: " << Helpers::formatPercentages(likelihoodTouchdownRush) << "%\n";
+                }
+            }
+        }
+    }
+
+    if (weighted != nullptr) {
+        cout << "\nRECENCY-WEIGHTED LIKELIHOODS (HALF-LIFE OF " << weighted->halfLifeSeasons << " SEASONS, WORTH ";
+        cout << static_cast<int>(weighted->effectiveSituations + 0.5f) << " SITUATIONS):\n";
+        if (currentSituation.isTwoPointConversion) {
+            cout << "    Two Point Conversion: " << Helpers::formatPercentages(weighted->twoPoint) << "%\n";
+        }
+        else {
+            cout << "    Field Goal: " << Helpers::formatPercentages(weighted->fieldGoal) << "%\n";
+            cout << "    First Down: " << Helpers::formatPercentages(weighted->firstDown) << "%\n";
+            cout << "    Touchdown: " << Helpers::formatPercentages(weighted->touchdown) << "%\n";
+        }
+    }
+
+    cout << "\nBEST HISTORICAL PLAY: " << bestPlay.playType;
+    if (bestPlay.isPass) {
+        cout << " " << bestPlay.passType;
+    }
+    else if (bestPlay.isRush) {
+        cout << " " << bestPlay.rushDirection;
+    }
+
+    //if best play starts with a vowel
+    if (bestPlay.formation[0] == 'A' || bestPlay.formation[0] == 'E' || bestPlay.formation[0] == 'I'
+        || bestPlay.formation[0] == 'O' || bestPlay.formation[0] == 'U') {
+        cout << " with an " << bestPlay.formation << " formation\n";
+    }
+    else {
+        cout << " with a " << bestPlay.formation << " formation\n";
+    }
+
+    //formatted output in paragraph form prints
+    cout << "    On " << bestPlay.gameDate << ", " << bestPlay.offense;
+    if (bestPlay.isTwoPointConversion && bestPlay.isTwoPointConversionSuccessful) {
+        cout << " scored 2 points ";
+        cout << "against " << bestPlay.defense << " during quarter " << bestPlay.quarter;
+        cout << " at time " << Helpers::formatTime(bestPlay.minutes, bestPlay.seconds) << ".\n";
+    }
+    else {
+        cout << " gained " << bestPlay.resultingYards << " yards ";
+        cout << "against " << bestPlay.defense << " during quarter " << bestPlay.quarter << " on down " << bestPlay.down;
+        cout << " on the " << bestPlay.yardLine << " yard line with " << bestPlay.toGo << " yards to go at time ";
+        cout << Helpers::formatTime(bestPlay.minutes, bestPlay.seconds) << ".\n";
+    }
+    cout << "The play ";
+    if (bestPlay.isTwoPointConversion) {
+        cout << "was a Two Point Conversion and was";
+        if (bestPlay.isTwoPointConversionSuccessful) {
+            cout << " ";
+        }
+        else {
+            cout << "not ";
+        }
+        cout << "successful.";
+    }
+    else {
+        if (bestPlay.isTouchdown) {
+            cout << "resulted in a touchdown.";
+        }
+        else {
+            cout << "did not result in a touchdown";
+            if (bestPlay.resultIsFirstDown) {
+                cout << ", but it did result in a first down.";
+            }
+            else {
+                cout << " or a first down.";
+            }
+        }
+    }
+    //descriptions are dropped when the data structures go over the memory budget
+    if (bestPlay.description.empty()) {
+        cout << endl;
+    }
+    else {
+        cout << "\nDescription: " << bestPlay.description << endl;
+    }
+    cout << "Game ID: " << bestPlay.gameID << endl << endl;
+    cout << "\n============================================= Welcome back to the Gridiron Guru! ============================================\n";
+}
+
+
+long SuccessTally::memoryBytes() const {
+    return static_cast<long>(subPlaySuccesses.capacity() * sizeof(int) + sparseSuccesses.capacity() * sizeof(SubPlaySuccess));
+}
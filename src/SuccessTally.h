@@ -0,0 +1,79 @@
+#pragma once
+#include <vector>
+
+
+#include "Play.h"
+#include "PlayDictionary.h"
+#include "RecencyWeighting.h"
+
+
+using namespace std;
+
+
+struct LikelihoodIntervals;
+
+
+//amount of successes for a specific play type and sub play type (pass type, rush direction, or formation)
+struct SubPlaySuccess {
+    int successes;
+    int playTypeCode;
+    int subTypeCode;
+};
+
+
+//counts the outcomes of similar situations for both data structures
+//successes per sub play are kept in a fixed-size array indexed by dictionary codes so a matched play never allocates
+class SuccessTally {
+public:
+    int situations = 0;
+    int firstDowns = 0;
+    int touchdowns = 0;
+    int conversions = 0;
+    int fieldGoals = 0;
+    int firstDownPasses = 0;
+    int firstDownRushes = 0;
+    int touchdownPasses = 0;
+    int touchdownRushes = 0;
+    int twoPointPasses = 0;
+    int twoPointRushes = 0;
+
+    //successes[playTypeCode * MAX_SUB_TYPES + subTypeCode]
+    vector<int> subPlaySuccesses;
+
+    //non-zero successes only, used in place of the dense array once a tally is compacted
+    vector<SubPlaySuccess> sparseSuccesses;
+
+    SuccessTally();
+
+    //counts a play that is within the bounds of the current situation
+    void add(const Play& play, bool twoPointQuery);
+
+    //most sub play successes a single play can have
+    static constexpr int MAX_SUCCESS_CELLS = 3;
+
+    //fills cells with the index into subPlaySuccesses of every sub play success of a play, returns how many there are
+    int successCells(const Play& play, bool twoPointQuery, int cells[MAX_SUCCESS_CELLS]) const;
+
+    //adds the counts of another tally into this one
+    void merge(const SuccessTally& other);
+
+    //keeps only the non-zero successes so a tally can be stored cheaply
+    void compact();
+
+
+    //bytes held by its arrays, for the memory report
+    long memoryBytes() const;
+
+    //returns the sub plays to print, from most to least successes
+    vector<SubPlaySuccess> rankSubPlays() const;
+
+    //prints likelihoods and the best historical play, along with recency-weighted likelihoods and intervals if given
+    void printSuggestion(const Play& currentSituation, const Play& bestPlay, const WeightedRates* weighted = nullptr,
+                         const LikelihoodIntervals* intervals = nullptr) const;
+
+private:
+    int extraPointCode;
+    int fieldGoalCode;
+    int twoPointPassCode;
+    int twoPointRushCode;
+};
@@ -0,0 +1,102 @@
+#include "WorkerPool.h"
+
+
+using namespace std;
+
+
+WorkerPool::WorkerPool(int threadCount) {
+    //the calling thread also works, so one less worker is started
+    for (int i = 1; i < threadCount; i++) {
+        workers.emplace_back(&WorkerPool::workerLoop, this);
+    }
+}
+
+
+WorkerPool::~WorkerPool() {
+    {
+        lock_guard<mutex> lock(poolMutex);
+        stopping = true;
+    }
+    jobReady.notify_all();
+    for (thread& worker : workers) {
+        worker.join();
+    }
+}
+
+
+WorkerPool& WorkerPool::shared() {
+    static WorkerPool pool(max(1, static_cast<int>(thread::hardware_concurrency())));
+    return pool;
+}
+
+
+//runs task(i) for every i from 0 to count-1 and returns once all of them are done
+void WorkerPool::parallelFor(int count, const function<void(int)>& task) {
+    if (count <= 0) {
+        return;
+    }
+    //small jobs or pools without workers just run on the calling thread
+    if (count == 1 || workers.empty()) {
+        for (int i = 0; i < count; i++) {
+            task(i);
+        }
+        return;
+    }
+
+    lock_guard<mutex> jobLock(jobMutex);
+    {
+        lock_guard<mutex> lock(poolMutex);
+        job = &task;
+        jobCount = count;
+        nextTask = 0;
+        activeWorkers = static_cast<int>(workers.size());
+        jobNumber++;
+    }
+    jobReady.notify_all();
+
+    runTasks();
+
+    //waits for the workers to finish the tasks they already took
+    unique_lock<mutex> lock(poolMutex);
+    jobDone.wait(lock, [this] { return activeWorkers == 0; });
+    job = nullptr;
+}
+
+
+int WorkerPool::size() const {
+    return static_cast<int>(workers.size()) + 1;
+}
+
+
+void WorkerPool::workerLoop() {
+    long lastJob = 0;
+    while (true) {
+        {
+            unique_lock<mutex> lock(poolMutex);
+            jobReady.wait(lock, [&] { return stopping || jobNumber != lastJob; });
+            if (stopping) {
+                return;
+            }
+            lastJob = jobNumber;
+        }
+
+        runTasks();
+
+        {
+            lock_guard<mutex> lock(poolMutex);
+            activeWorkers--;
+        }
+        jobDone.notify_one();
+    }
+}
+
+
+void WorkerPool::runTasks() {
+    while (true) {
+        int task = nextTask.fetch_add(1);
+        if (task >= jobCount) {
+            return;
+        }
+        (*job)(task);
+    }
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+
+
+using namespace std;
+
+
+//a fixed set of worker threads shared by everything that runs in parallel
+//parallelFor splits a range of tasks between the workers and the calling thread
+class WorkerPool {
+public:
+    explicit WorkerPool(int threadCount);
+
+    ~WorkerPool();
+
+    //the pool used by the program, sized to the hardware
+    static WorkerPool& shared();
+
+    //runs task(i) for every i from 0 to count-1 and returns once all of them are done
+    void parallelFor(int count, const function<void(int)>& task);
+
+    //amount of threads that work on a parallelFor, including the calling thread
+    int size() const;
+
+private:
+    void workerLoop();
+
+    //runs tasks of the current job until there are none left
+    void runTasks();
+
+    vector<thread> workers;
+    mutex poolMutex;
+    condition_variable jobReady;
+    condition_variable jobDone;
+
+    //current job, only one runs at a time
+    mutex jobMutex;
+    const function<void(int)>* job = nullptr;
+    int jobCount = 0;
+    atomic<int> nextTask{0};
+    int activeWorkers = 0;
+    long jobNumber = 0;
+    bool stopping = false;
+};
@@ -9,23 +9,137 @@
 #include "PlayMaxHeap.h"
 #include "PlayHashTable.h"
 #include "Helpers.h"
+#include "PlayIngest.h"
+#include "DriveSimulator.h"
+#include "ExpectedPoints.h"
+#include "Benchmark.h"
+#include "MemoryAccounting.h"
+#include "PlayDictionary.h"
+#include "BackendPreload.h"
+#include "DatasetSnapshot.h"
 
 
 using namespace std;
 
 
-int main() {
-    string filename;
+int main(int argc, char* argv[]) {
+    //a single .csv or a directory with a .csv per season
+    string filename = "../files/pbp2013-2024.csv";
+    //options every query is run with, the season range is prompted for each query
+    QueryOptions queryOptions;
+    //drives simulated from each situation, 0 if drives aren't simulated
+    long simulatedDrives = 0;
+    //loaded from the file, or solved and written to it if it can't be loaded
+    string expectedPointsFile;
+    //queries timed by the benchmark instead of prompting, 0 if not benchmarking
+    int benchmarkQueries = 0;
+    //seconds of queries hammered against repeated reloads instead of prompting, 0 if not stress testing
+    int stressSeconds = 0;
+    //indexes the descriptions so heap queries can also be filtered by keywords and player names
+    bool textIndex = false;
+    //prompts for the weights of the outcomes the best play is rated by with every query
+    bool customWeights = false;
+    //counts the calls on the next snap of the same drive after similar situations
+    bool nextSnap = false;
+    //prints the memory held by each data structure after it is built
+    bool showStats = false;
+    //bytes the data structures should stay under, 0 if there is no budget
+    long memoryBudget = 0;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--data" && i + 1 < argc) {
+            filename = argv[++i];
+        }
+        else if (arg == "--half-life" && i + 1 < argc && Helpers::validateInput(argv[i + 1], "positive", 0, 0)) {
+            queryOptions.halfLifeSeasons = stof(argv[++i]);
+        }
+        else if (arg == "--nearest" && i + 1 < argc && Helpers::validateInput(argv[i + 1], "int", 1, 1000)) {
+            queryOptions.nearestNeighbors = stoi(argv[++i]);
+        }
+        else if (arg == "--target-sample" && i + 1 < argc && Helpers::validateInput(argv[i + 1], "int", 1, 1000000)) {
+            queryOptions.targetSample = stoi(argv[++i]);
+        }
+        else if (arg == "--intervals") {
+            queryOptions.confidenceIntervals = true;
+        }
+        else if (arg == "--latency-budget" && i + 1 < argc && Helpers::validateInput(argv[i + 1], "int", 1, 60000)) {
+            queryOptions.latencyBudgetMs = stoi(argv[++i]);
+        }
+        else if (arg == "--expected-points" && i + 1 < argc) {
+            expectedPointsFile = argv[++i];
+        }
+        else if (arg == "--simulate-drives" && i + 1 < argc && Helpers::validateInput(argv[i + 1], "int", 1, 1000000000)) {
+            simulatedDrives = stol(argv[++i]);
+        }
+        else if (arg == "--bench" && i + 1 < argc && Helpers::validateInput(argv[i + 1], "int", 1, 1000000)) {
+            benchmarkQueries = stoi(argv[++i]);
+        }
+        else if (arg == "--stress" && i + 1 < argc && Helpers::validateInput(argv[i + 1], "int", 1, 3600)) {
+            stressSeconds = stoi(argv[++i]);
+        }
+        else if (arg == "--text-index") {
+            textIndex = true;
+        }
+        else if (arg == "--weights") {
+            customWeights = true;
+        }
+        else if (arg == "--next-snap") {
+            nextSnap = true;
+        }
+        else if (arg == "--stats") {
+            showStats = true;
+            queryOptions.showStats = true;
+        }
+        else if (arg == "--memory-budget" && i + 1 < argc && Helpers::validateInput(argv[i + 1], "int", 1, 1000000)) {
+            memoryBudget = stol(argv[++i]) * 1024 * 1024;
+        }
+        else {
+            cerr << "Usage: " << argv[0] << " [--data <file.csv or directory of season .csv files>]";
+            cerr << " [--half-life <seasons until a play counts half>]";
+            cerr << " [--nearest <K similar situations to use when nothing matches>]";
+            cerr << " [--target-sample <plays the window is widened or narrowed to>]";
+            cerr << " [--intervals] [--latency-budget <milliseconds for bootstrapping intervals>]";
+            cerr << " [--simulate-drives <drives simulated from each situation>]";
+            cerr << " [--expected-points <table file, solved and written if it doesn't exist>]";
+            cerr << " [--bench <queries to time the situation scans with>]";
+            cerr << " [--stress <seconds of queries during repeated reloads>]";
+            cerr << " [--text-index] [--next-snap] [--weights]";
+            cerr << " [--stats] [--memory-budget <megabytes the data structures should stay under>]\n";
+            return 1;
+        }
+    }
 
-    //for maxHeap
-    priority_queue<Play, vector<Play>, ComparePlay> maxHeap;
+    //amount of top historical plays shown per page
+    const int TOP_PLAYS_PAGE_SIZE = 5;
+
+    //columns and rows both data structures read from the file
+    IngestConfig ingestConfig = IngestConfig::defaultConfig();
+
+    if (benchmarkQueries > 0) {
+        return Benchmark::run(filename, ingestConfig, benchmarkQueries);
+    }
+    if (stressSeconds > 0) {
+        return Benchmark::stress(filename, ingestConfig, stressSeconds);
+    }
+    //drives can end with a punt, so the punts are read too and kept apart from both data structures
+    if (simulatedDrives > 0 || !expectedPointsFile.empty()) {
+        ingestConfig = IngestConfig::withPunts();
+    }
 
-    //hash map
-    vector<LinkedList> hashTable(500, LinkedList());
-    PlayHashTable table(500);
+    //what every dataset builds next to its data structures
+    DatasetOptions datasetOptions;
+    datasetOptions.nearestNeighbors = queryOptions.nearestNeighbors > 0;
+    datasetOptions.windowCounts = queryOptions.targetSample > 0;
+    datasetOptions.driveTransitions = simulatedDrives > 0;
+    datasetOptions.textIndex = textIndex;
+    datasetOptions.sequences = nextSnap;
+    datasetOptions.expectedPointsFile = expectedPointsFile;
 
-    //for calculation of top plays for hash table
-    priority_queue<Play, vector<Play>, ComparePlay> hashMaxHeap;
+    //the heap, hash table, and everything built from them, swapped as a whole when the data is reloaded
+    DatasetStore store;
+    shared_ptr<Dataset> firstDataset = make_shared<Dataset>();
+    store.publish(firstDataset);
+    long seenGeneration = 0;
 
     //welcome screen
     cout << "\n============================================= Welcome to the Gridiron Guru! =============================================\n";
@@ -35,6 +149,76 @@ int main() {
     static bool heapUsed = false;
     static bool hashTableUsed = false;
 
+    //releases the other data structure before a build when keeping both would go over the memory budget
+    //the new one is assumed to need about as much as the one already built
+    auto makeRoomFor = [&](Dataset& dataset, const string& dataStructureToBuild) {
+        if (memoryBudget == 0) {
+            return;
+        }
+        if (dataStructureToBuild == "1" && hashTableUsed && 2 * dataset.table.memoryUsage(dataset.hashTable).total() > memoryBudget) {
+            dataset.table.release(dataset.hashTable);
+            hashTableUsed = false;
+            cout << "Released the hash table to stay under the memory budget\n";
+        }
+        else if (dataStructureToBuild == "2" && heapUsed && 2 * dataset.maxHeap.memoryUsage().total() > memoryBudget) {
+            dataset.maxHeap = PlayMaxHeap();
+            heapUsed = false;
+            cout << "Released the heap to stay under the memory budget\n";
+        }
+    };
+
+    //drops cold fields once the data structures go over the memory budget and prints what each of them holds
+    //if they are still over it, they are released and it returns false, so no query runs past the budget
+    auto accountMemory = [&](Dataset& dataset) {
+        long used = (heapUsed ? dataset.maxHeap.memoryUsage().total() : 0) + (hashTableUsed ? dataset.table.memoryUsage(dataset.hashTable).total() : 0);
+        if (memoryBudget > 0 && used > memoryBudget) {
+            long freed = (heapUsed ? dataset.maxHeap.evictColdFields() : 0) + (hashTableUsed ? PlayHashTable::evictColdFields(dataset.hashTable) : 0);
+            used -= freed;
+            cout << "Dropped play descriptions to stay under the memory budget, freed " << MemoryAccounting::formatBytes(freed) << endl;
+            if (used > memoryBudget) {
+                cout << "The data still needs " << MemoryAccounting::formatBytes(used) << ", over the memory budget of "
+                     << MemoryAccounting::formatBytes(memoryBudget) << ", so it was released.\n";
+                cout << "Raise --memory-budget or point --data at fewer seasons.\n\n";
+                if (heapUsed) {
+                    dataset.maxHeap = PlayMaxHeap();
+                    heapUsed = false;
+                }
+                if (hashTableUsed) {
+                    dataset.table.release(dataset.hashTable);
+                    hashTableUsed = false;
+                }
+                return false;
+            }
+        }
+        if (showStats) {
+            if (heapUsed) {
+                dataset.maxHeap.memoryUsage().print();
+            }
+            if (hashTableUsed) {
+                dataset.table.memoryUsage(dataset.hashTable).print();
+            }
+            MemoryReport shared;
+            shared.title = "Shared memory";
+            shared.add("dictionaries", PlayDictionary::memoryBytes());
+            shared.add("drive transitions", dataset.driveTransitions.memoryBytes());
+            shared.add("expected points table", dataset.expectedPoints.memoryBytes());
+            shared.add("game sequences", dataset.sequences.memoryBytes());
+            shared.print();
+            cout << "Resident set: " << MemoryAccounting::formatBytes(MemoryAccounting::residentBytes()) << ", peak "
+                 << MemoryAccounting::formatBytes(MemoryAccounting::peakResidentBytes()) << endl;
+        }
+        return true;
+    };
+
+    //both data structures are built from a single parse while the prompts run
+    //a memory budget keeps building them one at a time, only when they are picked
+    BackendPreload preload;
+    if (memoryBudget == 0) {
+        preload.start(filename, ingestConfig,
+                      [&](vector<Play>& plays, ostream& log) { firstDataset->buildHeap(plays, datasetOptions, log); },
+                      [&](vector<Play>& plays, ostream& log) { firstDataset->buildHashTable(plays, datasetOptions, log); });
+    }
+
     //to read in all inputs from user
     while (true) {
         cout << "Provide the quarter, down, yards to go, time left, and current position on the field ";
@@ -45,43 +229,82 @@ int main() {
 
         Play currentSituation;
 
+        //every query uses the dataset that is current when it starts, even if a reload swaps in a new one meanwhile
+        shared_ptr<Dataset> dataset = store.current();
+        if (dataset->generation != seenGeneration) {
+            seenGeneration = dataset->generation;
+            heapUsed = dataset->heapBuilt;
+            hashTableUsed = dataset->hashTableBuilt;
+            cout << dataset->report;
+            dataset->stats.print(ingestConfig);
+            accountMemory(*dataset);
+        }
+
         //prompt data structure
-        cout << "Input \"1\" to use a maxHeap or \"2\" to use a hashTable below:\n";
+        cout << "Input \"1\" to use a maxHeap or \"2\" to use a hashTable below" << preload.status() << ":\n";
+        cout << (store.reloading() ? "(Reloading the data in the background)\n"
+                                   : "(Input \"reload\" to read the data again while queries keep running)\n");
         cin >> dataStructure;
-        if (dataStructure == "exit") {
+        if (!cin || dataStructure == "exit") {
             break;
         }
+        //the new dataset is built on a background thread and used by the first query after it is done
+        if (dataStructure == "reload") {
+            bool withHeap = memoryBudget == 0 || heapUsed;
+            bool withHashTable = memoryBudget == 0 || hashTableUsed;
+            if (!store.reloadInBackground(filename, ingestConfig, datasetOptions, withHeap, withHashTable)) {
+                cout << "A reload is already running.\n\n";
+            }
+            else {
+                cout << "Reloading the data in the background, queries keep using the current data until it is done.\n\n";
+            }
+            continue;
+        }
         //validates input for given prompt
         while (!Helpers::validateInput(dataStructure, "int", 1, 2)) {
             cout << "Input the number 1 or 2  below:\n";
             cin >> dataStructure;
         }
 
-        if (dataStructure == "1" && !heapUsed) {
-            filename = "../files/pbp2013-2024.csv";
-            cout << "Building Heap...\n";
+        makeRoomFor(*dataset, dataStructure);
+        Backend backend = dataStructure == "1" ? HEAP_BACKEND : HASH_TABLE_BACKEND;
+        bool& backendUsed = dataStructure == "1" ? heapUsed : hashTableUsed;
+        if (!backendUsed && dataset->generation == 0 && preload.enabled(backend)) {
+            backendUsed = true;
 
-            heapUsed = true;
-
-            auto start = chrono::high_resolution_clock::now();
-            PlayMaxHeap::readDataAndPushIntoHeap(filename, maxHeap);
-            auto stop = chrono::high_resolution_clock::now();
-            auto time = duration_cast<chrono::microseconds>(stop-start);
-
-            cout << "Build took " << (float)time.count()/(float)1000000 << " seconds!\n";
+            //only waits if the background thread hasn't finished this data structure yet
+            if (!preload.ready(backend)) {
+                cout << (backend == HEAP_BACKEND ? "Waiting for the heap to finish building...\n"
+                                                 : "Waiting for the hash table to finish building...\n");
+            }
+            preload.wait(backend);
+            preload.printBuild(backend);
+            if (!accountMemory(*dataset)) {
+                continue;
+            }
         }
-        else if (dataStructure == "2" && !hashTableUsed){
-            filename = "../files/pbp2013-2024.csv";
-            cout << "Building Hash Table...\n";
+        else if (!backendUsed) {
+            cout << (backend == HEAP_BACKEND ? "Building Heap...\n" : "Building Hash Table...\n");
 
-            hashTableUsed = true;
+            backendUsed = true;
 
             auto start = chrono::high_resolution_clock::now();
-            PlayHashTable::readDataAndPushIntoHashMap(filename, hashTable);
+            vector<Play> plays;
+            IngestStats stats = PlayIngest::readFiles(PlayIngest::listDataFiles(filename), ingestConfig, plays);
+            if (backend == HEAP_BACKEND) {
+                dataset->buildHeap(plays, datasetOptions, cout);
+            }
+            else {
+                dataset->buildHashTable(plays, datasetOptions, cout);
+            }
             auto stop = chrono::high_resolution_clock::now();
-            auto time = duration_cast<chrono::microseconds>(stop-start);
+            auto time = chrono::duration_cast<chrono::microseconds>(stop-start);
 
             cout << "Build took " << (float)time.count()/(float)1000000 << " seconds!\n";
+            stats.print(ingestConfig);
+            if (!accountMemory(*dataset)) {
+                continue;
+            }
         }
 
         //prompt current qtr
@@ -151,6 +374,75 @@ int main() {
         currentSituation.seconds = stoi(to_string(input[3]-'0') + to_string(input[4]-'0'));
         currentSituation.timeAsInt = Helpers::timeToInt(currentSituation.minutes, currentSituation.seconds);
 
+        //prompt offense to filter by
+        cout << "Input OFFENSE team abbreviation (like KC) or \"any\" below:\n";
+        cin >> input;
+        if (input == "exit") {
+            break;
+        }
+        //validates input for given prompt
+        while (!Helpers::validateInput(input, "team", 0, 0)) {
+            cout << "Input OFFENSE team abbreviation (like KC) or \"any\" below:\n";
+            cin >> input;
+        }
+        currentSituation.offense = input == "any" ? "" : input;
+
+        //prompt defense to filter by
+        cout << "Input DEFENSE team abbreviation (like KC) or \"any\" below:\n";
+        cin >> input;
+        if (input == "exit") {
+            break;
+        }
+        //validates input for given prompt
+        while (!Helpers::validateInput(input, "team", 0, 0)) {
+            cout << "Input DEFENSE team abbreviation (like KC) or \"any\" below:\n";
+            cin >> input;
+        }
+        currentSituation.defense = input == "any" ? "" : input;
+
+        //prompt seasons to filter by
+        cout << "Input SEASONS as a year (like 2023), a range (like 2021-2024), or \"any\" below:\n";
+        cin >> input;
+        if (input == "exit") {
+            break;
+        }
+        //validates input for given prompt
+        while (!Helpers::validateInput(input, "seasons", 0, 0)) {
+            cout << "Input SEASONS as a year (like 2023), a range (like 2021-2024), or \"any\" below:\n";
+            cin >> input;
+        }
+        queryOptions.seasons = Helpers::parseSeasonRange(input);
+
+        //prompt keywords to filter by, a whole line so they can have spaces
+        if (textIndex) {
+            cout << "Input KEYWORDS or players (like SHOTGUN DEEP LEFT or J.ALLEN), or \"any\" below:\n";
+            getline(cin >> ws, input);
+            if (input == "exit") {
+                break;
+            }
+            queryOptions.keywords = input == "any" ? "" : input;
+            if (!queryOptions.keywords.empty() && dataStructure == "2") {
+                cout << "Keywords only filter heap queries, so they are ignored by the hash table.\n";
+            }
+        }
+
+        //prompt the weights the best play is rated by, so each query can use a different team's appetite for risk
+        if (customWeights) {
+            cout << "Input SCORING WEIGHTS of a first down, touchdown, interception, fumble, two point conversion, and yards^0.75\n"
+                 << "(like 10,10,-100,-1000,5,1), or \"default\" below:\n";
+            cin >> input;
+            if (input == "exit") {
+                break;
+            }
+            //validates input for given prompt
+            while (!Helpers::validateInput(input, "weights", 0, 0)) {
+                cout << "Input SCORING WEIGHTS of a first down, touchdown, interception, fumble, two point conversion, and yards^0.75\n"
+                     << "(like 10,10,-100,-1000,5,1), or \"default\" below:\n";
+                cin >> input;
+            }
+            queryOptions.weights = Helpers::parseScoringWeights(input);
+        }
+
         //checks if inputs from user qualifies for two point conversion
         if (currentSituation.down == 0 && currentSituation.toGo == 0 && (currentSituation.yardLine == 98 || currentSituation.yardLine == 99)) {
             currentSituation.isTwoPointConversion = true;
@@ -164,23 +456,44 @@ int main() {
         //depending on chosen data structure, will suggest plays differently
         if (dataStructure == "1") {
             //for maxHeap structure
-            PlayMaxHeap::suggestPlayFromHeap(currentSituation, maxHeap);
+            const PlayMaxHeap& maxHeap = dataset->maxHeap;
+            vector<int> matchedRows = PlayMaxHeap::suggestPlayFromHeap(currentSituation, maxHeap, queryOptions);
+
+            //pages through the similar situations the query matched, keywords included, without copying the heap
+            HeapTopWalk topPlays(maxHeap, std::move(matchedRows), queryOptions.weights);
+            int rank = 1;
+            while (!topPlays.done()) {
+                cout << "TOP " << (rank == 1 ? "" : "(CONTINUED) ") << "HISTORICAL PLAYS:\n";
+                rank = HeapTopWalk::printPage(topPlays.next(TOP_PLAYS_PAGE_SIZE), rank);
+                if (topPlays.done()) {
+                    cout << endl;
+                    break;
+                }
+
+                cout << "Input \"more\" to see the next " << TOP_PLAYS_PAGE_SIZE << " plays or anything else to continue:\n";
+                cin >> input;
+                if (input != "more") {
+                    break;
+                }
+            }
         }
         else {
             //for hash table
-            string currentHashCode = Helpers::generatePlayCode(currentSituation);
+            //uses every bucket whose hash code can hold similar plays
+            dataset->table.suggestPlayFromHashTable(currentSituation, dataset->hashTable, queryOptions);
+        }
 
-            //finds hash code that has similar plays
-            int index = table.hash_func(currentHashCode, hashTable);
-            LinkedList plays = hashTable[index];
-            Play* currentPlay = plays.head;
+        //expected points and the fourth down decision are a lookup into the solved table
+        dataset->expectedPoints.printDecision(currentSituation);
 
-            //puts similar plays in a heap to later be calculated
-            while (currentPlay != nullptr) {
-                hashMaxHeap.push(*currentPlay);
-                currentPlay = currentPlay->next;
-            }
-            PlayHashTable::suggestPlayFromHashTable(currentSituation, hashMaxHeap);
+        //how the whole drive could end from here, two point conversions aren't drives
+        if (simulatedDrives > 0) {
+            DriveSimulator::simulate(dataset->driveTransitions, currentSituation, simulatedDrives).print();
+        }
+
+        //what offenses called next after the similar situations, walked game by game in clock order
+        if (nextSnap) {
+            dataset->sequences.nextSnaps(Helpers::calculateSituationBounds(currentSituation, queryOptions.seasons)).print();
         }
     }
     cout << "Exiting program.\n";
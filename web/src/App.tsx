@@ -1,11 +1,18 @@
-import { useState, useEffect, useCallback } from 'react';
+import { useState, useEffect, useCallback, useRef } from 'react';
 import Header from './components/Header';
 import InputForm from './components/InputForm.tsx';
 import ResultsDisplay from './components/ResultsDisplayEnhanced';
 import LoadingScreen from './components/LoadingScreen.tsx';
 import Footer from './components/Footer.tsx';
 import { Play, CurrentSituation, AnalysisResult } from './types/Play';
-import { loadPlayData, LoadProgress } from './utils/dataLoader';
+import {
+  loadPlayData,
+  LoadProgress,
+  ExportManifest,
+  loadExportManifest,
+  loadSituationPlays,
+  loadDescription
+} from './utils/dataLoader';
 import { analyzeWithHeap } from './utils/heapAnalysis';
 import { PlayHashTable, analyzeWithHashTable } from './utils/hashTableAnalysis';
 
@@ -14,6 +21,9 @@ type DataStructure = 'heap' | 'hashtable';
 function App() {
   const [plays, setPlays] = useState<Play[]>([]);
   const [hashTable, setHashTable] = useState<PlayHashTable | null>(null);
+  // set when the exported shards are available, plays are then fetched per quarter and down instead of all at once
+  const [manifest, setManifest] = useState<ExportManifest | null>(null);
+  const shardTables = useRef(new Map<string, PlayHashTable>());
   const [loading, setLoading] = useState(true);
   const [loadProgress, setLoadProgress] = useState<LoadProgress>({ 
     loaded: 0, 
@@ -28,6 +38,13 @@ function App() {
   useEffect(() => {
     async function initData() {
       try {
+        const exported = await loadExportManifest();
+        if (exported) {
+          setManifest(exported);
+          setLoading(false);
+          return;
+        }
+
         const loadedPlays = await loadPlayData(setLoadProgress);
         setPlays(loadedPlays);
 
@@ -53,12 +70,37 @@ function App() {
     setResult(null);
 
     // use setTimeout to allow UI to update before heavy computation
-    setTimeout(() => {
+    setTimeout(async () => {
       const startTime = performance.now();
 
       let analysisResult: AnalysisResult;
 
-      if (dataStructure === 'hashtable' && hashTable) {
+      if (manifest) {
+        // only the shard of this quarter and down is downloaded, and only once
+        try {
+          const shardKey = `${situation.quarter}-${situation.down}`;
+          const shardPlays = await loadSituationPlays(manifest, situation.quarter, situation.down);
+
+          if (dataStructure === 'hashtable') {
+            let table = shardTables.current.get(shardKey);
+            if (!table) {
+              table = PlayHashTable.buildFromPlays(shardPlays);
+              shardTables.current.set(shardKey, table);
+            }
+            analysisResult = analyzeWithHashTable(situation, table);
+          } else {
+            analysisResult = analyzeWithHeap(situation, shardPlays);
+          }
+
+          if (analysisResult.bestPlay) {
+            analysisResult.bestPlay.description = await loadDescription(analysisResult.bestPlay);
+          }
+        } catch (err) {
+          setError(err instanceof Error ? err.message : 'Failed to load play data');
+          setAnalyzing(false);
+          return;
+        }
+      } else if (dataStructure === 'hashtable' && hashTable) {
         analysisResult = analyzeWithHashTable(situation, hashTable);
       } else {
         analysisResult = analyzeWithHeap(situation, plays);
@@ -69,7 +111,9 @@ function App() {
       setResult(analysisResult);
       setAnalyzing(false);
     }, 50);
-  }, [plays, hashTable]);
+  }, [plays, hashTable, manifest]);
+
+  const playCount = manifest ? manifest.plays : plays.length;
 
   if (loading) {
     return <LoadingScreen progress={loadProgress} />;
@@ -92,12 +136,12 @@ function App() {
         <section className="context-band">
           <div className="context-card">
             <span className="card-label">Historical Sample</span>
-            <strong>{plays.length.toLocaleString()}</strong>
+            <strong>{playCount.toLocaleString()}</strong>
             <small>plays from 2013-2024</small>
           </div>
           <div className="context-card">
             <span className="card-label">Data Structures Ready</span>
-            <strong>{hashTable ? 'Heap · Hash Table' : 'Building...'}</strong>
+            <strong>{hashTable || manifest ? 'Heap · Hash Table' : 'Building...'}</strong>
             <small>optimized for instant lookups</small>
           </div>
           <div className="context-card">
@@ -111,7 +155,7 @@ function App() {
           <InputForm 
             onAnalyze={handleAnalyze}
             disabled={analyzing}
-            playCount={plays.length}
+            playCount={playCount}
           />
 
           <div className="insights-panel" aria-live="polite">
@@ -119,7 +163,7 @@ function App() {
               <div className="analyzing-indicator">
                 <div className="pulse-ring" aria-hidden="true"></div>
                 <div>
-                  <p>Crunching {plays.length.toLocaleString()} plays...</p>
+                  <p>Crunching {playCount.toLocaleString()} plays...</p>
                   <span>We sift through every comparable snap before recommending a call.</span>
                 </div>
               </div>
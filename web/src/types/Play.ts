@@ -32,6 +32,10 @@ export interface Play {
   isTwoPointConversionSuccessful: boolean;
   twoPointWeight: number;
   rushDirection: string;
+  // set on plays loaded from the exported shards, which leave out descriptions
+  exportRow?: number;
+  fieldGoalIsGood?: boolean;
+  descriptionMentionsPass?: boolean;
 }
 
 export interface CurrentSituation {
@@ -135,6 +139,7 @@ export interface BestPlayInfo {
   isRush: boolean;
   description: string;
   gameID: number;
+  exportRow?: number;
 }
 
 export function createEmptyPlay(): Play {
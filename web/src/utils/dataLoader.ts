@@ -126,3 +126,159 @@ function parsePlayRow(data: string[]): Play | null {
     return null;
   }
 }
+
+// sharded aggregates written by the GridironExport tool, so a query only downloads its own situations
+const EXPORT_URL = 'https://raw.githubusercontent.com/JettNguyen/GridironGuru/master/files/export';
+
+export interface ExportManifest {
+  version: number;
+  plays: number;
+  teams: string[];
+  playTypes: string[];
+  subTypes: string[];
+  flags: Record<string, number>;
+  // [plays, first downs, touchdowns, field goals, two point conversions] of every shard
+  shards: Record<string, number[]>;
+}
+
+interface SituationShard {
+  quarter: number;
+  down: number;
+  plays: number;
+  columns: Record<string, number[]>;
+  // [plays, first downs, touchdowns, field goals, two point conversions, row of the best play] of every play code
+  cells: Record<string, number[]>;
+}
+
+interface TextShard {
+  rows: number[];
+  descriptions: string[];
+}
+
+const situationCache = new Map<string, Promise<Play[]>>();
+const textCache = new Map<string, Promise<Map<number, string>>>();
+
+function shardName(quarter: number, down: number): string {
+  return `q${quarter}d${down}`;
+}
+
+function dateFromInt(date: number): string {
+  if (date === 0) return '';
+  const text = String(date);
+  return `${text.slice(0, 4)}-${text.slice(4, 6)}-${text.slice(6, 8)}`;
+}
+
+async function fetchJson<T>(path: string): Promise<T> {
+  const response = await fetch(`${EXPORT_URL}/${path}`);
+  if (!response.ok) {
+    throw new Error(`Failed to load ${path}: ${response.status}`);
+  }
+  return response.json() as Promise<T>;
+}
+
+// resolves to null when no export has been published, so the caller can fall back to the full csv
+export async function loadExportManifest(): Promise<ExportManifest | null> {
+  try {
+    const manifest = await fetchJson<ExportManifest>('manifest.json');
+    return manifest.version === 1 ? manifest : null;
+  } catch {
+    return null;
+  }
+}
+
+// every play of a quarter and down, the only plays either analysis compares a situation against
+export function loadSituationPlays(manifest: ExportManifest, quarter: number, down: number): Promise<Play[]> {
+  const name = shardName(quarter, down);
+  if (!manifest.shards[name]) {
+    return Promise.resolve([]);
+  }
+
+  let cached = situationCache.get(name);
+  if (!cached) {
+    cached = fetchJson<SituationShard>(`situations/${name}.json`).then(shard => decodeShard(manifest, shard));
+    // a failed fetch is retried on the next query instead of being cached
+    cached.catch(() => situationCache.delete(name));
+    situationCache.set(name, cached);
+  }
+  return cached;
+}
+
+function decodeShard(manifest: ExportManifest, shard: SituationShard): Play[] {
+  const columns = shard.columns;
+  const flag = (row: number, name: string) => (columns.flags[row] & manifest.flags[name]) !== 0;
+  const plays: Play[] = [];
+
+  for (let row = 0; row < shard.plays; row++) {
+    const play = createEmptyPlay();
+    play.exportRow = row;
+    play.gameID = columns.gameID[row];
+    play.gameDate = dateFromInt(columns.date[row]);
+    play.quarter = shard.quarter;
+    play.down = shard.down;
+    play.minutes = columns.minutes[row];
+    play.seconds = columns.seconds[row];
+    play.timeAsInt = timeToInt(play.minutes, play.seconds);
+    play.offense = manifest.teams[columns.offense[row]] || '';
+    play.defense = manifest.teams[columns.defense[row]] || '';
+    play.toGo = columns.toGo[row];
+    play.yardLine = columns.yardLine[row];
+    play.resultingYards = columns.yards[row];
+    play.yardsWeight = calculateWeight(play.resultingYards);
+    play.formation = manifest.subTypes[columns.formation[row]] || '';
+    play.playType = manifest.playTypes[columns.playType[row]] || '';
+    play.passType = manifest.subTypes[columns.passType[row]] || '';
+    play.rushDirection = manifest.subTypes[columns.rushDirection[row]] || '';
+
+    play.resultIsFirstDown = flag(row, 'firstDown');
+    play.isTouchdown = flag(row, 'touchdown');
+    play.isRush = flag(row, 'rush');
+    play.isPass = flag(row, 'pass');
+    play.isIncomplete = flag(row, 'incomplete');
+    play.isSack = flag(row, 'sack');
+    play.isInterception = flag(row, 'interception');
+    play.isFumble = flag(row, 'fumble');
+    play.isTwoPointConversion = flag(row, 'twoPoint');
+    play.isTwoPointConversionSuccessful = flag(row, 'twoPointSuccess');
+    play.fieldGoalIsGood = flag(row, 'fieldGoalGood');
+    play.descriptionMentionsPass = flag(row, 'descriptionPass');
+
+    // same weights as parsePlayRow
+    play.firstDownWeight = play.resultIsFirstDown ? 10.0 : 0;
+    play.touchdownWeight = play.isTouchdown ? 10.0 : 0;
+    play.interceptionWeight = play.isInterception ? -100.0 : 0;
+    play.fumbleWeight = play.isFumble ? -1000.0 : 0;
+    play.twoPointWeight = play.isTwoPointConversionSuccessful ? 5.0 : 0;
+
+    plays.push(play);
+  }
+
+  return plays;
+}
+
+// descriptions are split by yardLine, so showing the best play only downloads a tenth of its shard's text
+export async function loadDescription(
+  play: { quarter: number; down: number; yardLine: number; exportRow?: number }
+): Promise<string> {
+  if (play.exportRow === undefined) {
+    return '';
+  }
+
+  const tens = Math.min(Math.max(Math.floor(play.yardLine / 10), 0), 9);
+  const name = `${shardName(play.quarter, play.down)}y${tens}`;
+  let cached = textCache.get(name);
+  if (!cached) {
+    cached = fetchJson<TextShard>(`text/${name}.json`).then(shard => {
+      const descriptions = new Map<number, string>();
+      shard.rows.forEach((row, i) => descriptions.set(row, shard.descriptions[i]));
+      return descriptions;
+    });
+    cached.catch(() => textCache.delete(name));
+    textCache.set(name, cached);
+  }
+
+  try {
+    return (await cached).get(play.exportRow) || '';
+  } catch {
+    return '';
+  }
+}
@@ -1,5 +1,5 @@
 import { Play, CurrentSituation, AnalysisResult } from '../types/Play';
-import { generatePlayCode } from './helpers';
+import { generatePlayCode, isSuggestablePlay } from './helpers';
 import { analyzeWithHeap } from './heapAnalysis';
 
 interface HashNode {
@@ -43,13 +43,7 @@ export class PlayHashTable {
 
   insert(play: Play): void {
     // skip unwanted play types (matching C++ logic)
-    if (!play.playType || 
-        play.playType === 'NO PLAY' || 
-        play.playType === 'TIMEOUT' ||
-        play.playType === 'KICK OFF' || 
-        play.playType === 'PUNT' || 
-        play.playType === 'EXTRA POINT' ||
-        play.playType === 'QB KNEEL') {
+    if (!isSuggestablePlay(play)) {
       return;
     }
 
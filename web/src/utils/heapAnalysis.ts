@@ -13,7 +13,8 @@ import {
 	calculateTimeBounds,
 	calculateToGoBounds,
 	calculateYardLineBounds,
-	comparePlayRatings
+	comparePlayRatings,
+	isSuggestablePlay
 } from './helpers';
 
 export function analyzeWithHeap(
@@ -78,7 +79,8 @@ export function analyzeWithHeap(
 		isPass: bestPlay.isPass,
 		isRush: bestPlay.isRush,
 		description: bestPlay.description,
-		gameID: bestPlay.gameID
+		gameID: bestPlay.gameID,
+		exportRow: bestPlay.exportRow
 	};
 
 	return {
@@ -125,6 +127,9 @@ function filterSimilarPlays(situation: CurrentSituation, plays: Play[]): Play[]
 
 	const [timeLower, timeUpper] = calculateTimeBounds(situation.minutes, situation.seconds);
 
+	// the full csv still has the kicks, timeouts and kneels the export leaves out
+	plays = plays.filter(isSuggestablePlay);
+
 	let filtered = plays.filter(play =>
 		play.quarter === situation.quarter &&
 		play.down === situation.down &&
@@ -400,7 +405,7 @@ function calculateStats(situation: CurrentSituation, plays: Play[]): PlayStats {
 		if (situation.isTwoPointConversion && play.isTwoPointConversion && play.playType !== 'EXTRA POINT') {
 			if (play.isTwoPointConversionSuccessful) {
 				stats.conversions++;
-				if (play.description.includes('PASS')) {
+				if (play.descriptionMentionsPass ?? play.description.includes('PASS')) {
 					stats.twoPointPasses++;
 				} else {
 					stats.twoPointRushes++;
@@ -427,7 +432,7 @@ function calculateStats(situation: CurrentSituation, plays: Play[]): PlayStats {
 			}
 		}
 
-		if (play.playType === 'FIELD GOAL' && play.description.includes('IS GOOD')) {
+		if (play.fieldGoalIsGood ?? (play.playType === 'FIELD GOAL' && play.description.includes('IS GOOD'))) {
 			stats.fieldGoals++;
 		}
 	}
@@ -165,6 +165,13 @@ export function parseTimeString(timeStr: string): { minutes: number; seconds: nu
   return { minutes, seconds };
 }
 
+// same play types IngestConfig::defaultConfig skips, so the csv fallback and the export count the same rows
+const SKIPPED_PLAY_TYPES = new Set(['', 'NO PLAY', 'TIMEOUT', 'KICK OFF', 'PUNT', 'EXTRA POINT', 'QB KNEEL']);
+
+export function isSuggestablePlay(play: Play): boolean {
+  return !SKIPPED_PLAY_TYPES.has(play.playType || '');
+}
+
 export function getPlayRating(play: Play): number {
   return play.firstDownWeight + play.yardsWeight + play.touchdownWeight + 
          play.interceptionWeight + play.twoPointWeight + play.fumbleWeight;